@@ -24,6 +24,10 @@
  *   This example stets up a web page, where switch action can take place.
  *   The repay can be also altered with the push button. 
  *   The thing will delay actions arriving within 10 seconds.
+ *   The state shown on the page is updated live from the status event
+ *   stream of IotWebConf, without reloading the page. This stream carries
+ *   only the status, so it is served without logging in. (The
+ *   configuration is sent by handleEvents(), that requires to log in.)
  *   
  *   This example also provides the firmware update option.
  *   (See previous examples for more details!)
@@ -116,6 +120,7 @@ void setup()
   // -- Set up required URL handlers on the web server.
   server.on("/", handleRoot);
   server.on("/config", []{ iotWebConf.handleConfig(); });
+  server.on("/status-events", []{ iotWebConf.handleStatusEvents(); });
   server.onNotFound([](){ iotWebConf.handleNotFound(); });
 
   Serial.println("Ready.");
@@ -162,6 +167,8 @@ void applyAction(unsigned long now)
     }
     Serial.print("Switched ");
     Serial.println(state == HIGH ? "ON" : "OFF");
+    // -- Pages open receive the new state.
+    iotWebConf.publishStatus("state", state == HIGH ? "ON" : "OFF");
     needAction = NO_ACTION;
     lastAction = now;
   }
@@ -197,15 +204,17 @@ void handleRoot()
   s += iotWebConf.getHtmlFormatProvider()->getStyle();
   s += "<title>IotWebConf 08 Web Relay</title></head><body>";
   s += iotWebConf.getThingName();
-  s += "<div>State: ";
+  s += "<div>State: <span id='state'>";
   s += (state == HIGH ? "ON" : "OFF");
-  s += "</div>";
+  s += "</span></div>";
   s += "<div>";
   s += "<button type='button' onclick=\"location.href='?action=on';\" >Turn ON</button>";
   s += "<button type='button' onclick=\"location.href='?action=off';\" >Turn OFF</button>";
   s += "<button type='button' onclick=\"location.href='?';\" >Refresh</button>";
   s += "</div>";
   s += "<div>Go to <a href='config'>configure page</a> to change values.</div>";
+  s += "<script>new EventSource('status-events').addEventListener('status', function(e) { ";
+  s += "document.getElementById('state').textContent=JSON.parse(e.data).state; });</script>";
   s += "</body></html>\n";
 
   server.send(200, "text/html", s);
@@ -0,0 +1,186 @@
+/**
+ * IotWebConfEpollTransport.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <IotWebConfEpollTransport.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// -- Events processed in one poll() at most.
+#define IOTWEBCONF_EPOLL_MAX_EVENTS 64
+#define IOTWEBCONF_EPOLL_READ_SIZE 4096
+#define IOTWEBCONF_EPOLL_LISTEN_BACKLOG 1024
+
+namespace iotwebconf
+{
+
+EpollTransport::EpollTransport(const char* bindAddress)
+{
+  this->_bindAddress = bindAddress;
+}
+
+EpollTransport::~EpollTransport()
+{
+  for (PosixConnection* connection : this->_closedConnections)
+  {
+    this->release(connection);
+  }
+  // -- Connections still open are left to the process exit.
+  if (this->_listenFd >= 0)
+  {
+    ::close(this->_listenFd);
+  }
+  if (this->_epollFd >= 0)
+  {
+    ::close(this->_epollFd);
+  }
+}
+
+bool EpollTransport::begin(uint16_t port, AsyncConnectionHandler* handler)
+{
+  this->_handler = handler;
+  this->_epollFd = epoll_create1(0);
+  this->_listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if ((this->_epollFd < 0) || (this->_listenFd < 0))
+  {
+    return false;
+  }
+  int one = 1;
+  setsockopt(this->_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  if ((this->_bindAddress != NULL)
+    && (inet_pton(AF_INET, this->_bindAddress, &address.sin_addr) != 1))
+  {
+    return false;
+  }
+  if ((bind(this->_listenFd, (struct sockaddr*)&address, sizeof(address)) != 0)
+    || (listen(this->_listenFd, IOTWEBCONF_EPOLL_LISTEN_BACKLOG) != 0))
+  {
+    return false;
+  }
+  // -- Listening socket is marked by a NULL pointer.
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.ptr = NULL;
+  return epoll_ctl(this->_epollFd, EPOLL_CTL_ADD, this->_listenFd, &event) == 0;
+}
+
+void EpollTransport::poll()
+{
+  if (this->_epollFd < 0)
+  {
+    return;
+  }
+
+  // -- Connections closed by the server since the last call are dropped
+  //    before waiting, so that no event refers to them.
+  for (PosixConnection* connection : this->_closedConnections)
+  {
+    this->release(connection);
+  }
+  this->_closedConnections.clear();
+
+  struct epoll_event events[IOTWEBCONF_EPOLL_MAX_EVENTS];
+  int count =
+    epoll_wait(this->_epollFd, events, IOTWEBCONF_EPOLL_MAX_EVENTS, 0);
+  for (int i = 0; i < count; i++)
+  {
+    PosixConnection* connection = (PosixConnection*)events[i].data.ptr;
+    if (connection == NULL)
+    {
+      this->accept();
+    }
+    else if (!connection->_closed && !this->receive(connection))
+    {
+      this->_handler->onDisconnect(connection);
+      // -- Not closed by the server, so not in the list yet.
+      connection->_closed = true;
+      this->_closedConnections.push_back(connection);
+    }
+  }
+}
+
+void EpollTransport::wait(int timeoutMillis)
+{
+  if ((this->_epollFd < 0) || !this->_closedConnections.empty())
+  {
+    return;
+  }
+  // -- Level triggered, so the event is reported again by poll().
+  struct epoll_event event;
+  epoll_wait(this->_epollFd, &event, 1, timeoutMillis);
+}
+
+void EpollTransport::accept()
+{
+  while (true)
+  {
+    int fd = accept4(this->_listenFd, NULL, NULL, SOCK_NONBLOCK);
+    if (fd < 0)
+    {
+      return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    PosixConnection* connection = new PosixConnection(fd);
+    connection->_closedConnections = &this->_closedConnections;
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.ptr = connection;
+    epoll_ctl(this->_epollFd, EPOLL_CTL_ADD, fd, &event);
+    this->_handler->onConnect(connection);
+  }
+}
+
+/**
+ * Deliver all data waiting on the socket. Returns false, if the connection
+ * was closed by the client, or failed.
+ */
+bool EpollTransport::receive(PosixConnection* connection)
+{
+  char buffer[IOTWEBCONF_EPOLL_READ_SIZE];
+  while (!connection->_closed)
+  {
+    ssize_t length = recv(connection->_fd, buffer, sizeof(buffer), 0);
+    if (length > 0)
+    {
+      this->_handler->onData(connection, buffer, length);
+    }
+    else if ((length < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+    {
+      return true;
+    }
+    else
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void EpollTransport::release(PosixConnection* connection)
+{
+  // -- Closing the socket also removes it from the epoll set.
+  ::close(connection->_fd);
+  delete connection;
+}
+
+} // end namespace
@@ -0,0 +1,61 @@
+/**
+ * IotWebConfEpollTransport.h -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfEpollTransport_h
+#define IotWebConfEpollTransport_h
+
+#include <vector>
+#include <IotWebConfPosixTransport.h>
+
+namespace iotwebconf
+{
+
+/**
+ * AsyncTransport for Linux. Unlike PosixTransport, the sockets are watched
+ * by epoll, so a poll() costs the same with thousands of idle connections
+ * as with a single one. That is what load testing tools (e.g. wrk, ab)
+ * need.
+ */
+class EpollTransport : public AsyncTransport
+{
+public:
+  /**
+   * @bindAddress - E.g. "127.0.0.1" to listen on localhost only, NULL for
+   *   all interfaces.
+   */
+  EpollTransport(const char* bindAddress = "127.0.0.1");
+  ~EpollTransport();
+
+  bool begin(uint16_t port, AsyncConnectionHandler* handler) override;
+  void poll() override;
+
+  /**
+   * Block until a socket has something to be handled, or timeoutMillis
+   * passes. Events are left for the next poll(). A host program's loop
+   * waits here instead of sleeping, so requests are picked up at once.
+   */
+  void wait(int timeoutMillis);
+
+private:
+  const char* _bindAddress;
+  int _listenFd = -1;
+  int _epollFd = -1;
+  AsyncConnectionHandler* _handler = NULL;
+  std::vector<PosixConnection*> _closedConnections;
+
+  void accept();
+  bool receive(PosixConnection* connection);
+  void release(PosixConnection* connection);
+};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ * IotWebConfHost.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+/**
+ * Serves the config portal of IotWebConf (the parameters of example
+ * IotWebConf03CustomParameters) on a Linux host, for load testing and
+ * profiling the library code. See README.md in this folder.
+ *
+ * Usage: iotwebconf-host [port [dns-port]]
+ *   Config portal is at http://127.0.0.1:8080/config by default, user
+ *   "admin", password "smrtTHNG8266". Captive DNS answers on port 5353.
+ *   Event stream is at /events, publishing the uptime every second, and
+ *   without authentication (the uptime only) at /status-events.
+ */
+
+#include <IotWebConf.h>
+#include <IotWebConfEpollTransport.h>
+
+using namespace iotwebconf;
+
+#define STRING_LEN 128
+#define NUMBER_LEN 32
+
+char stringParamValue[STRING_LEN];
+char intParamValue[NUMBER_LEN];
+char floatParamValue[NUMBER_LEN];
+char checkboxParamValue[STRING_LEN];
+char chooserParamValue[STRING_LEN];
+
+static char chooserValues[][STRING_LEN] = { "red", "blue", "darkYellow" };
+static char chooserNames[][STRING_LEN] = { "Red", "Blue", "Dark yellow" };
+
+// -- Created in main(), as ports are given on the command line.
+IotWebConf* iotWebConf;
+TextParameter stringParam = TextParameter("String param", "stringParam", stringParamValue, STRING_LEN);
+ParameterGroup group1 = ParameterGroup("group1", "");
+NumberParameter intParam = NumberParameter("Int param", "intParam", intParamValue, NUMBER_LEN, "20", "1..100", "min='1' max='100' step='1'");
+ParameterGroup group2 = ParameterGroup("c_factor", "Calibration factor");
+NumberParameter floatParam = NumberParameter("Float param", "floatParam", floatParamValue, NUMBER_LEN,  NULL, "e.g. 23.4", "step='0.1'");
+CheckboxParameter checkboxParam = CheckboxParameter("Check param", "checkParam", checkboxParamValue, STRING_LEN,  true);
+SelectParameter chooserParam = SelectParameter("Choose param", "chooseParam", chooserParamValue, STRING_LEN, (char*)chooserValues, (char*)chooserNames, sizeof(chooserValues) / STRING_LEN, STRING_LEN);
+
+void handleRoot(WebRequestWrapper* webRequestWrapper)
+{
+  if (iotWebConf->handleCaptivePortal(webRequestWrapper))
+  {
+    return;
+  }
+  String s = "<!DOCTYPE html><html lang=\"en\"><head><meta name=\"viewport\" content=\"width=device-width, initial-scale=1, user-scalable=no\"/>";
+  s += "<title>IotWebConf host</title></head><body>Hello world!";
+  s += "<ul><li>String param value: ";
+  s += stringParamValue;
+  s += "<li>Int param value: ";
+  s += atoi(intParamValue);
+  s += "</ul>Go to <a href='config'>configure page</a> to change values.";
+  s += "</body></html>\n";
+  webRequestWrapper->send(200, "text/html", s);
+}
+
+int main(int argc, char** argv)
+{
+  uint16_t port = argc > 1 ? atoi(argv[1]) : 8080;
+  uint16_t dnsPort = argc > 2 ? atoi(argv[2]) : 5353;
+
+  EpollTransport transport;
+  AsyncWebServerWrapper server(&transport, port);
+  CaptiveDnsServer dnsServer;
+  IotWebConf iotWebConfInstance(
+    "testThing", &dnsServer, &server, "smrtTHNG8266", "hst1");
+  iotWebConf = &iotWebConfInstance;
+
+  group1.addItem(&intParam);
+  group2.addItem(&floatParam);
+  group2.addItem(&checkboxParam);
+  group2.addItem(&chooserParam);
+  iotWebConf->addSystemParameter(&stringParam);
+  iotWebConf->addParameterGroup(&group1);
+  iotWebConf->addParameterGroup(&group2);
+  iotWebConf->setSessionAuth(true);
+  iotWebConf->init();
+
+  server.on("/", handleRoot);
+  server.on("/config",
+    [](WebRequestWrapper* r) { iotWebConf->handleConfig(r); });
+  server.on("/config.json", "PATCH",
+    [](WebRequestWrapper* r) { iotWebConf->handleConfigPatch(r); });
+  server.on("/config.json",
+    [](WebRequestWrapper* r) { iotWebConf->handleConfigJson(r); });
+  server.on("/events",
+    [](WebRequestWrapper* r) { iotWebConf->handleEvents(r); });
+  server.on("/status-events",
+    [](WebRequestWrapper* r) { iotWebConf->handleStatusEvents(r); });
+  server.onNotFound(
+    [](WebRequestWrapper* r) { iotWebConf->handleNotFound(r); });
+  server.begin();
+  dnsServer.start(IPAddress(127, 0, 0, 1), dnsPort);
+
+  Serial.print(F("Config portal: http://127.0.0.1:"));
+  Serial.print(port);
+  Serial.println(F("/config"));
+  Serial.flush();
+  unsigned long uptime = 0;
+  while (true)
+  {
+    iotWebConf->doLoop();
+    if (millis() / 1000 != uptime)
+    {
+      uptime = millis() / 1000;
+      iotWebConf->publishStatus("uptime", (long)uptime);
+    }
+    // -- Instead of the sleeps of IotWebConf::delay(), wait for the sockets,
+    //    to measure the portal code and not the idle back-off.
+    transport.wait(1);
+  }
+  return 0;
+}
@@ -0,0 +1,279 @@
+/**
+ * IotWebConfIdle.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+/**
+ * Measures how much CPU time the library takes while there is little to do,
+ * which is what the power use of a device mostly depends on. Time is
+ * simulated (see HostClock): the web and DNS servers are stand-ins costing
+ * a few microseconds per poll and some milliseconds per request, and
+ * delay() counts as idle time, as the device would sleep meanwhile.
+ * Measured are a long IotWebConf::delay(), and an application calling
+ * doLoop() on its own while nobody uses the portal (polled on heartbeats
+ * only, see IOTWEBCONF_PORTAL_HEARTBEAT_MILLIS).
+ *
+ * Usage: iotwebconf-idle
+ */
+
+#include <IotWebConf.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace iotwebconf;
+
+// -- Cost of a poll, when nothing has arrived (microseconds).
+#define IDLE_HTTP_POLL_MICROS 5
+#define IDLE_DNS_POLL_MICROS 3
+// -- Cost of serving a request (microseconds).
+#define IDLE_REQUEST_MICROS 3000
+
+/**
+ * Event stream of a viewer. Like with AsyncWebServerWrapper, data written
+ * is sent by the next poll of the web server.
+ */
+class SimulatedStream : public WebStream
+{
+public:
+  bool connected() override { return true; };
+  bool write(const char* data, size_t length) override
+  {
+    if (!this->pending)
+    {
+      this->pending = true;
+      this->writtenAt = hostClock.now;
+    }
+    return true;
+  };
+  void close() override { };
+
+  bool pending = false;
+  uint64_t writtenAt = 0;
+};
+
+/**
+ * Request of a viewer opening an event stream. Nothing else is used.
+ */
+class ViewerRequest : public WebRequestWrapper
+{
+public:
+  using WebRequestWrapper::hasArg;
+  using WebRequestWrapper::arg;
+  using WebRequestWrapper::sendHeader;
+  using WebRequestWrapper::send;
+  using WebRequestWrapper::sendContent;
+
+  ViewerRequest(WebStream* stream) { this->_stream = stream; };
+  const String hostHeader() const override { return String(""); };
+  IPAddress localIP() override { return IPAddress(127, 0, 0, 1); };
+  const String uri() const override { return String("/status-events"); };
+  bool authenticate(const char* username, const char* password) override { return true; };
+  void requestAuthentication() override { };
+  bool hasArg(const String& name) override { return false; };
+  String arg(const String name) override { return String(""); };
+  void sendHeader(const String& name, const String& value, bool first = false) override { };
+  void setContentLength(const size_t contentLength) override { };
+  void send(int code, const char* content_type = NULL, const String& content = String("")) override { };
+  void sendContent(const String& content) override { };
+  void sendContent_P(PGM_P content, size_t size) override { };
+  void stop() override { };
+  WebStream* openStream(const char* content_type) override { return this->_stream; };
+
+private:
+  WebStream* _stream;
+};
+
+/**
+ * Web server serving a request, whenever one was made to arrive, and
+ * noting how long the request waited. Also sends the data written to the
+ * stream of a viewer.
+ */
+class SimulatedWebServer : public WebServerWrapper
+{
+public:
+  void begin() override { };
+  bool handleClient() override
+  {
+    hostClock.spend(IDLE_HTTP_POLL_MICROS);
+    if ((this->stream != NULL) && this->stream->pending)
+    {
+      this->stream->pending = false;
+      this->streamLatencies.push_back(hostClock.now - this->stream->writtenAt);
+    }
+    if (!this->_pending || (hostClock.now < this->_arrival))
+    {
+      return false;
+    }
+    this->_pending = false;
+    this->latencies.push_back(hostClock.now - this->_arrival);
+    hostClock.spend(IDLE_REQUEST_MICROS);
+    return true;
+  };
+  void arriveAt(uint64_t micros)
+  {
+    this->_arrival = micros;
+    this->_pending = true;
+  };
+  uint64_t maxLatency()
+  {
+    return this->latencies.empty()
+      ? 0 : *std::max_element(this->latencies.begin(), this->latencies.end());
+  };
+
+  std::vector<uint64_t> latencies;
+  SimulatedStream* stream = NULL;
+  std::vector<uint64_t> streamLatencies;
+
+private:
+  bool _pending = false;
+  uint64_t _arrival = 0;
+};
+
+class SimulatedDnsServer : public DnsServerWrapper
+{
+public:
+  void processNextRequest() override
+  {
+    hostClock.spend(IDLE_DNS_POLL_MICROS);
+  };
+};
+
+static SimulatedWebServer webServer;
+static SimulatedDnsServer dnsServer;
+static IotWebConf* iotWebConf;
+
+static void resetCounters()
+{
+  hostClock.busy = 0;
+  hostClock.idle = 0;
+  webServer.latencies.clear();
+  webServer.streamLatencies.clear();
+}
+
+static double busyPercent(uint64_t since)
+{
+  return 100.0 * hostClock.busy / (hostClock.now - since);
+}
+
+/**
+ * A 10 s IotWebConf::delay() of an application with a loop task of its own,
+ * and a request arriving every second.
+ */
+static void measureDelay()
+{
+  static LoopTask applicationTask("app",
+    [](unsigned long budgetMicros) { hostClock.spend(150); }, 1000);
+  iotWebConf->addLoopTask(&applicationTask);
+  resetCounters();
+  uint64_t start = hostClock.now;
+  for (int i = 0; i < 10; i++)
+  {
+    webServer.arriveAt(hostClock.now + 500000);
+    iotWebConf->delay(1000);
+  }
+  printf("delay(10 s), 150 us task, a request every second:\n");
+  printf("  CPU busy %.2f%%, request pick-up latency max %.2f ms\n",
+    busyPercent(start), webServer.maxLatency() / 1000.0);
+  applicationTask.suspended = true;
+
+  // -- A task running longer than the delay must not make it sleep more.
+  static LoopTask slowTask("slow",
+    [](unsigned long budgetMicros) { hostClock.spend(7000); }, 1000);
+  iotWebConf->addLoopTask(&slowTask);
+  start = hostClock.now;
+  iotWebConf->delay(5);
+  printf("delay(5 ms) with a 7 ms task returned after %.2f ms\n",
+    (hostClock.now - start) / 1000.0);
+  slowTask.suspended = true;
+}
+
+/**
+ * Application calling doLoop() on its own for the time given, doing 20 us
+ * of work of its own in every loop(). Returns the count of loop() calls.
+ */
+static long runLoops(uint64_t micros)
+{
+  uint64_t end = hostClock.now + micros;
+  long loops = 0;
+  while (hostClock.now < end)
+  {
+    iotWebConf->doLoop();
+    hostClock.spend(20);
+    loops++;
+  }
+  return loops;
+}
+
+static void waitForIdlePortal()
+{
+  runLoops((IOTWEBCONF_PORTAL_ACTIVE_HOLD_MILLIS + 1000) * 1000ULL);
+}
+
+static double maxMillis(const std::vector<uint64_t>& latencies)
+{
+  return latencies.empty()
+    ? 0 : *std::max_element(latencies.begin(), latencies.end()) / 1000.0;
+}
+
+static void measureHeartbeat()
+{
+  printf("Application calling doLoop() with 20 us work of its own:\n");
+  WiFi.stationNum = 1;
+  runLoops(1000000);
+  printf("  station connected    %7ld loop()/s\n", runLoops(1000000));
+
+  WiFi.stationNum = 0;
+  waitForIdlePortal();
+  printf("  nobody using portal  %7ld loop()/s\n", runLoops(1000000));
+  // -- Requests arriving at different points between two heartbeats.
+  resetCounters();
+  for (int i = 0; i < 5; i++)
+  {
+    webServer.arriveAt(hostClock.now + (i * 10 + 7) * 1000);
+    runLoops(100000);
+    waitForIdlePortal();
+  }
+  printf("  request while idle picked up after max %.2f ms\n",
+    webServer.maxLatency() / 1000.0);
+
+  // -- An open event stream keeps the portal polled at full rate.
+  webServer.stream = new SimulatedStream();
+  ViewerRequest viewerRequest(webServer.stream);
+  runLoops(1000);
+  iotWebConf->handleStatusEvents(&viewerRequest);
+  waitForIdlePortal();
+  resetCounters();
+  long loops = runLoops(1000000);
+  for (int i = 0; i < 5; i++)
+  {
+    iotWebConf->publishStatus("uptime", (long)(hostClock.now / 1000000));
+    runLoops(1000000 + i * 9000);
+  }
+  printf("  event stream open    %7ld loop()/s, event sent after max %.3f ms\n",
+    loops, maxMillis(webServer.streamLatencies));
+  iotWebConf->getStatusEventSource()->close();
+  webServer.stream = NULL;
+}
+
+int main(int argc, char** argv)
+{
+  // -- Always starts from the initial configuration.
+  setenv("IOTWEBCONF_EEPROM_FILE", "/dev/null", 1);
+  hostClock.simulated = true;
+
+  IotWebConf instance(
+    "idleThing", &dnsServer, &webServer, "smrtTHNG8266", "idl1");
+  iotWebConf = &instance;
+  iotWebConf->init();
+
+  measureDelay();
+  measureHeartbeat();
+  return 0;
+}
@@ -0,0 +1,254 @@
+/**
+ * IotWebConfNumbers.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+/**
+ * Checks the routines of IotWebConfNumber.h: random values of every type
+ * (floats and doubles as random bit patterns) are formatted and parsed back,
+ * and must give the very same value. Decimals near the middle of two floats
+ * must be parsed as the nearest float. Then measures the throughput of the
+ * routines against the String/strtoll()/atof()/IPAddress way they replaced.
+ * Exits with 1 when any value was not given back.
+ *
+ * Usage: iotwebconf-numbers [values]
+ */
+
+#include <IotWebConfNumber.h>
+
+#include <time.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace iotwebconf;
+
+static std::mt19937_64 random64(1);
+static char text[IOTWEBCONF_NUMBER_TEXT_SIZE];
+static int failures = 0;
+// -- Results are summed here, so that the optimizer keeps the work.
+static volatile uint64_t sink;
+
+static double nowNanos()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+static void failed(const char* type, const char* formatted)
+{
+  if (failures++ < 10)
+  {
+    printf("  %s not given back: '%s'\n", type, formatted);
+  }
+}
+
+static void checkRoundTrip(long count)
+{
+  long floats = 0;
+  long doubles = 0;
+  for (long i = 0; i < count; i++)
+  {
+    uint32_t floatBits = (uint32_t)random64();
+    float f;
+    memcpy(&f, &floatBits, sizeof(f));
+    if (isfinite(f))
+    {
+      size_t length = formatFloat(f, text, sizeof(text));
+      float parsed;
+      if (!parseFloat(text, length, &parsed)
+        || (memcmp(&parsed, &f, sizeof(f)) != 0))
+      {
+        failed("float", text);
+      }
+      floats++;
+    }
+
+    uint64_t doubleBits = random64();
+    double d;
+    memcpy(&d, &doubleBits, sizeof(d));
+    if (isfinite(d))
+    {
+      size_t length = formatDouble(d, text, sizeof(text));
+      double parsed;
+      if (!parseDouble(text, length, &parsed)
+        || (memcmp(&parsed, &d, sizeof(d)) != 0))
+      {
+        failed("double", text);
+      }
+      doubles++;
+    }
+
+    // -- Shifted, so that short numbers are checked as well.
+    int64_t signedValue = (int64_t)random64() >> (random64() % 64);
+    static const int bases[] = { 2, 8, 10, 16, 36 };
+    for (int base : bases)
+    {
+      size_t length = formatSigned(signedValue, text, sizeof(text), base);
+      int64_t parsed;
+      if (!parseSigned(text, length, INT64_MIN, INT64_MAX, &parsed, base)
+        || (parsed != signedValue))
+      {
+        failed("signed", text);
+      }
+    }
+    uint64_t unsignedValue = random64() >> (random64() % 64);
+    size_t length = formatUnsigned(unsignedValue, text, sizeof(text));
+    uint64_t parsedUnsigned;
+    if (!parseUnsigned(text, length, UINT64_MAX, &parsedUnsigned)
+      || (parsedUnsigned != unsignedValue))
+    {
+      failed("unsigned", text);
+    }
+
+    IPAddress ip((uint32_t)random64());
+    length = formatIp(ip, text, sizeof(text));
+    IPAddress parsedIp;
+    if (!parseIp(text, length, &parsedIp) || ((uint32_t)parsedIp != (uint32_t)ip))
+    {
+      failed("IP", text);
+    }
+
+    int digits = 1 + random64() % 16;
+    uint64_t hex = digits < 16
+      ? random64() & ((1ULL << (4 * digits)) - 1) : random64();
+    length = formatHex(hex, digits, text, sizeof(text));
+    uint64_t parsedHex;
+    if (!parseHex(text, length, digits, &parsedHex) || (parsedHex != hex))
+    {
+      failed("hex", text);
+    }
+  }
+  printf("Round trip: %ld floats, %ld doubles, %ld integers (5 bases), "
+    "%ld IPs, %ld hex values: %d failed\n",
+    floats, doubles, count * 6, count, count, failures);
+}
+
+/**
+ * Values cycle through a small set, like the parameters of a config.
+ */
+#define MEASURE(NAME, COUNT, BODY) \
+  { \
+    double start = nowNanos(); \
+    for (long i = 0; i < (COUNT); i++) \
+    { \
+      size_t v = i & 1023; \
+      BODY; \
+    } \
+    printf("  %-30s %7.1f ns\n", NAME, (nowNanos() - start) / (COUNT)); \
+  }
+
+/**
+ * Decimals close to the middle between two floats are rounded to a double
+ * right in the middle, when parsed as a double. Floats must be rounded from
+ * the decimal (as the strtof() of glibc does), not from that double.
+ */
+static void checkFloatRounding(long count)
+{
+  int before = failures;
+  long checked = 0;
+  for (long i = 0; i < count; i++)
+  {
+    uint32_t floatBits = (uint32_t)random64() & 0x7FFFFFFF;
+    float f;
+    memcpy(&f, &floatBits, sizeof(f));
+    float next = nextafterf(f, INFINITY);
+    if (!isfinite(next) || (f == 0))
+    {
+      continue;
+    }
+    double middle = ((double)f + (double)next) / 2;
+    int length = snprintf(text, sizeof(text), "%.*e",
+      (int)(13 + random64() % 4), middle);
+    float parsed;
+    if (!parseFloat(text, length, &parsed) || (parsed != strtof(text, NULL)))
+    {
+      failed("float (rounding)", text);
+    }
+    checked++;
+  }
+  printf("Floats near the middle of two floats: %ld, %d not rounded right\n",
+    checked, failures - before);
+}
+
+static void measure(long count)
+{
+  std::vector<int32_t> ints;
+  std::vector<float> floats;
+  std::vector<IPAddress> ips;
+  std::vector<std::string> intTexts;
+  std::vector<std::string> floatTexts;
+  std::vector<std::string> ipTexts;
+  for (int i = 0; i < 1024; i++)
+  {
+    ints.push_back((int32_t)random64());
+    // -- Values as typed on the config page, e.g. "-123.45".
+    floats.push_back((float)((int)(random64() % 200000) - 100000) / 100);
+    ips.push_back(IPAddress((uint32_t)random64()));
+    formatSigned(ints.back(), text, sizeof(text));
+    intTexts.push_back(text);
+    formatFloat(floats.back(), text, sizeof(text));
+    floatTexts.push_back(text);
+    formatIp(ips.back(), text, sizeof(text));
+    ipTexts.push_back(text);
+  }
+
+  // -- Posted values used to arrive as a String (WebRequestWrapper::arg()).
+  printf("Time of one operation (old way, then IotWebConfNumber.h):\n");
+  MEASURE("int parse    strtoll(String)", count,
+    String s(intTexts[v].c_str()); sink += strtoll(s.c_str(), NULL, 10));
+  MEASURE("int parse    parseSigned()", count,
+    int64_t p; parseSigned(intTexts[v].data(), intTexts[v].size(),
+      INT32_MIN, INT32_MAX, &p); sink += p);
+  MEASURE("int format   String(value)", count,
+    String s(ints[v]); sink += s.length());
+  MEASURE("int format   formatSigned()", count,
+    sink += formatSigned(ints[v], text, sizeof(text)));
+  MEASURE("float parse  atof(String)", count,
+    String s(floatTexts[v].c_str()); sink += (int64_t)atof(s.c_str()));
+  MEASURE("float parse  parseFloat()", count,
+    float p; parseFloat(floatTexts[v].data(), floatTexts[v].size(), &p);
+      sink += (int64_t)p);
+  MEASURE("float format String(value)", count,
+    String s(floats[v]); sink += s.length());
+  MEASURE("float format formatFloat()", count,
+    sink += formatFloat(floats[v], text, sizeof(text)));
+  MEASURE("IP parse     fromString(String)", count,
+    String s(ipTexts[v].c_str()); IPAddress p; p.fromString(s);
+      sink += (uint32_t)p);
+  MEASURE("IP parse     parseIp()", count,
+    IPAddress p; parseIp(ipTexts[v].data(), ipTexts[v].size(), &p);
+      sink += (uint32_t)p);
+  MEASURE("IP format    toString()", count,
+    String s = ips[v].toString(); sink += s.length());
+  MEASURE("IP format    formatIp()", count,
+    sink += formatIp(ips[v], text, sizeof(text)));
+  MEASURE("hex format   formatHex(8 digits)", count,
+    sink += formatHex((uint32_t)ints[v], 8, text, sizeof(text)));
+
+  // -- String(float) writes two decimals only.
+  int lost = 0;
+  for (int i = 0; i < 1024; i++)
+  {
+    float f = (float)random64() / 1e15f;
+    String s(f);
+    lost += ((float)atof(s.c_str()) != f) ? 1 : 0;
+  }
+  printf("Floats not given back by String(value) and atof(): %d of 1024\n", lost);
+}
+
+int main(int argc, char** argv)
+{
+  long count = argc > 1 ? atol(argv[1]) : 1000000;
+  checkRoundTrip(count);
+  checkFloatRounding(count);
+  measure(count);
+  return failures == 0 ? 0 : 1;
+}
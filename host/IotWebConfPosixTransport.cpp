@@ -0,0 +1,217 @@
+/**
+ * IotWebConfPosixTransport.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <IotWebConfPosixTransport.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// -- Bytes offered to the server for writing at once. The socket buffer
+//    decides how much is actually taken.
+#define IOTWEBCONF_POSIX_WRITE_SPACE 16384
+// -- Size of the buffer a socket is read into.
+#define IOTWEBCONF_POSIX_READ_SIZE 4096
+#define IOTWEBCONF_POSIX_LISTEN_BACKLOG 128
+
+namespace iotwebconf
+{
+
+static bool setNonBlocking(int fd)
+{
+  int flags = fcntl(fd, F_GETFL, 0);
+  return (flags >= 0) && (fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0);
+}
+
+size_t PosixConnection::space()
+{
+  return this->_closed ? 0 : IOTWEBCONF_POSIX_WRITE_SPACE;
+}
+
+size_t PosixConnection::write(const char* data, size_t length)
+{
+  ssize_t written = ::send(this->_fd, data, length, MSG_NOSIGNAL);
+  // -- Errors other than a full socket buffer are detected by poll().
+  return written < 0 ? 0 : written;
+}
+
+void PosixConnection::close()
+{
+  // -- Socket is closed and the connection is deleted by the transport.
+  this->_closed = true;
+  if (this->_closedConnections != NULL)
+  {
+    this->_closedConnections->push_back(this);
+  }
+}
+
+IPAddress PosixConnection::localIP()
+{
+  struct sockaddr_in address;
+  socklen_t length = sizeof(address);
+  if (getsockname(this->_fd, (struct sockaddr*)&address, &length) != 0)
+  {
+    return IPAddress();
+  }
+  // -- Both are in network byte order.
+  return IPAddress((uint32_t)address.sin_addr.s_addr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+PosixTransport::PosixTransport(const char* bindAddress)
+{
+  this->_bindAddress = bindAddress;
+}
+
+PosixTransport::~PosixTransport()
+{
+  for (PosixConnection* connection : this->_connections)
+  {
+    ::close(connection->_fd);
+    delete connection;
+  }
+  if (this->_listenFd >= 0)
+  {
+    ::close(this->_listenFd);
+  }
+}
+
+bool PosixTransport::begin(uint16_t port, AsyncConnectionHandler* handler)
+{
+  this->_handler = handler;
+  this->_listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  if (this->_listenFd < 0)
+  {
+    return false;
+  }
+  int one = 1;
+  setsockopt(this->_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  if ((this->_bindAddress != NULL)
+    && (inet_pton(AF_INET, this->_bindAddress, &address.sin_addr) != 1))
+  {
+    return false;
+  }
+  return (bind(this->_listenFd, (struct sockaddr*)&address, sizeof(address)) == 0)
+    && (listen(this->_listenFd, IOTWEBCONF_POSIX_LISTEN_BACKLOG) == 0)
+    && setNonBlocking(this->_listenFd);
+}
+
+void PosixTransport::poll()
+{
+  if (this->_listenFd < 0)
+  {
+    return;
+  }
+
+  // -- Connections closed by the server since the last call are dropped.
+  size_t kept = 0;
+  for (PosixConnection* connection : this->_connections)
+  {
+    if (connection->_closed)
+    {
+      ::close(connection->_fd);
+      delete connection;
+    }
+    else
+    {
+      this->_connections[kept++] = connection;
+    }
+  }
+  this->_connections.resize(kept);
+
+  std::vector<struct pollfd> fds(this->_connections.size() + 1);
+  fds[0].fd = this->_listenFd;
+  fds[0].events = POLLIN;
+  for (size_t i = 0; i < this->_connections.size(); i++)
+  {
+    fds[i + 1].fd = this->_connections[i]->_fd;
+    fds[i + 1].events = POLLIN;
+  }
+  if (::poll(fds.data(), fds.size(), 0) <= 0)
+  {
+    return;
+  }
+
+  // -- Connections are checked before accepting new ones, so indexes of
+  //    fds still match.
+  for (size_t i = 0; i < this->_connections.size(); i++)
+  {
+    PosixConnection* connection = this->_connections[i];
+    if (((fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) != 0)
+      && !connection->_closed && !this->receive(connection))
+    {
+      this->_handler->onDisconnect(connection);
+      connection->_closed = true;
+    }
+  }
+  if ((fds[0].revents & POLLIN) != 0)
+  {
+    this->accept();
+  }
+}
+
+void PosixTransport::accept()
+{
+  while (true)
+  {
+    int fd = ::accept(this->_listenFd, NULL, NULL);
+    if (fd < 0)
+    {
+      return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setNonBlocking(fd);
+    PosixConnection* connection = new PosixConnection(fd);
+    this->_connections.push_back(connection);
+    this->_handler->onConnect(connection);
+  }
+}
+
+/**
+ * Deliver all data waiting on the socket. Returns false, if the connection
+ * was closed by the client, or failed.
+ */
+bool PosixTransport::receive(PosixConnection* connection)
+{
+  char buffer[IOTWEBCONF_POSIX_READ_SIZE];
+  while (!connection->_closed)
+  {
+    ssize_t length = recv(connection->_fd, buffer, sizeof(buffer), 0);
+    if (length > 0)
+    {
+      this->_handler->onData(connection, buffer, length);
+    }
+    else if ((length < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+    {
+      return true;
+    }
+    else
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end namespace
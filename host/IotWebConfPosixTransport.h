@@ -0,0 +1,76 @@
+/**
+ * IotWebConfPosixTransport.h -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfPosixTransport_h
+#define IotWebConfPosixTransport_h
+
+#include <vector>
+#include <IotWebConfAsyncWebServer.h>
+
+namespace iotwebconf
+{
+
+class PosixTransport;
+
+/**
+ * A non-blocking socket accepted by the PosixTransport.
+ */
+class PosixConnection final : public AsyncConnection
+{
+public:
+  PosixConnection(int fd) { this->_fd = fd; };
+
+  size_t space() override;
+  size_t write(const char* data, size_t length) override;
+  void close() override;
+  IPAddress localIP() override;
+
+private:
+  int _fd;
+  bool _closed = false;
+  // -- Connections closed by the server are collected here, if set.
+  std::vector<PosixConnection*>* _closedConnections = NULL;
+  friend class PosixTransport;
+  friend class EpollTransport;
+};
+
+/**
+ * AsyncTransport over non-blocking POSIX sockets, for running the web server
+ * (and IotWebConf handlers) on a host computer, e.g. for load testing. Socket
+ * readiness is checked by poll() without waiting, so it fits into doLoop()
+ * just like on the device.
+ */
+class PosixTransport : public AsyncTransport
+{
+public:
+  /**
+   * @bindAddress - E.g. "127.0.0.1" to listen on localhost only, NULL for
+   *   all interfaces.
+   */
+  PosixTransport(const char* bindAddress = "127.0.0.1");
+  ~PosixTransport();
+
+  bool begin(uint16_t port, AsyncConnectionHandler* handler) override;
+  void poll() override;
+
+private:
+  const char* _bindAddress;
+  int _listenFd = -1;
+  AsyncConnectionHandler* _handler = NULL;
+  std::vector<PosixConnection*> _connections;
+
+  void accept();
+  bool receive(PosixConnection* connection);
+};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,194 @@
+/**
+ * IotWebConfPosts.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+/**
+ * Measures config posts with many fields: 50, 200 and 500 text parameters
+ * are posted (and saved) through handleConfig(). Arguments are looked up
+ * once through the index of IndexedWebRequestWrapper, and once with a
+ * request not able to list its arguments, so that every lookup scans all
+ * of them (as WebServer::arg() does). Exits with 1, when a post was not
+ * saved.
+ *
+ * Usage: iotwebconf-posts [posts]
+ */
+
+#include <IotWebConf.h>
+
+#include <time.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace iotwebconf;
+
+// -- Length of the value buffer of a parameter.
+#define POSTS_VALUE_LENGTH 16
+
+static double nowMicros()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+}
+
+/**
+ * Form post with its arguments in a list, looked up one by one. With
+ * 'listed', the arguments can also be walked through, so that IotWebConf
+ * indexes them.
+ */
+class FormRequest : public WebRequestWrapper
+{
+public:
+  using WebRequestWrapper::hasArg;
+  using WebRequestWrapper::arg;
+  using WebRequestWrapper::sendHeader;
+  using WebRequestWrapper::send;
+  using WebRequestWrapper::sendContent;
+
+  FormRequest(bool listed) { this->_listed = listed; };
+  void add(const String& name, const String& value)
+  {
+    this->_names.push_back(name);
+    this->_values.push_back(value);
+  };
+
+  const String hostHeader() const override { return String("192.168.4.1"); };
+  IPAddress localIP() override { return IPAddress(192, 168, 4, 1); };
+  const String uri() const override { return String("/config"); };
+  bool authenticate(const char* username, const char* password) override { return true; };
+  void requestAuthentication() override { };
+  bool hasArg(const String& name) override { return this->find(name) >= 0; };
+  String arg(const String name) override
+  {
+    int i = this->find(name);
+    return i < 0 ? String("") : this->_values[i];
+  };
+  int args() override { return this->_listed ? (int)this->_names.size() : -1; };
+  String argName(int i) override { return this->_names[i]; };
+  String argValue(int i) override { return this->_values[i]; };
+  void sendHeader(const String& name, const String& value, bool first = false) override { };
+  void setContentLength(const size_t contentLength) override { };
+  void send(int code, const char* content_type = NULL, const String& content = String("")) override
+  {
+    this->saved = content.indexOf("Configuration saved") >= 0;
+  };
+  void sendContent(const String& content) override { };
+  void sendContent_P(PGM_P content, size_t size) override { };
+  void stop() override { };
+
+  bool saved = false;
+
+private:
+  bool _listed;
+  std::vector<String> _names;
+  std::vector<String> _values;
+
+  int find(const String& name)
+  {
+    for (size_t i = 0; i < this->_names.size(); i++)
+    {
+      if (this->_names[i] == name)
+      {
+        return i;
+      }
+    }
+    return -1;
+  }
+};
+
+/**
+ * Requests are passed to handleConfig() directly, nothing is served.
+ */
+class NoWebServer : public WebServerWrapper
+{
+public:
+  void begin() override { };
+  bool handleClient() override { return false; };
+};
+
+/**
+ * Microseconds of a post of 'fields' parameters, with arguments indexed
+ * or not. Returns a negative value, when a post was not saved.
+ */
+static double measure(int fields, bool indexed, int posts)
+{
+  std::vector<std::string> ids(fields);
+  std::vector<std::vector<char>> values(fields);
+  // -- Parameters are not moved, when more are added.
+  std::deque<TextParameter> parameters;
+  ParameterGroup group("fields", "Fields");
+  for (int i = 0; i < fields; i++)
+  {
+    ids[i] = "field" + std::to_string(i);
+    values[i].resize(POSTS_VALUE_LENGTH);
+    parameters.emplace_back(ids[i].c_str(), ids[i].c_str(),
+      values[i].data(), POSTS_VALUE_LENGTH);
+    group.addItem(&parameters.back());
+  }
+  // -- DNS server is not started.
+  CaptiveDnsServer dnsServer;
+  NoWebServer webServer;
+  IotWebConf iotWebConf(
+    "postThing", &dnsServer, &webServer, "smrtTHNG8266", "pst1");
+  iotWebConf.addParameterGroup(&group);
+  iotWebConf.init();
+
+  double total = 0;
+  for (int p = 0; p < posts; p++)
+  {
+    // -- Fields are posted in the order of the form.
+    FormRequest request(indexed);
+    request.add("iwcThingName", "postThing");
+    request.add("iwcApPassword", "");
+    request.add("iwcWifiSsid", "network");
+    request.add("iwcWifiPassword", "");
+    request.add("iwcApTimeout", "30");
+    for (int i = 0; i < fields; i++)
+    {
+      request.add(ids[i].c_str(), String("value") + (p + i));
+    }
+    request.add("iotSave", "true");
+
+    double start = nowMicros();
+    iotWebConf.handleConfig(&request);
+    total += nowMicros() - start;
+    if (!request.saved)
+    {
+      return -1;
+    }
+  }
+  return total / posts;
+}
+
+int main(int argc, char** argv)
+{
+  int posts = argc > 1 ? atoi(argv[1]) : 200;
+
+  // -- Always starts from the initial configuration.
+  setenv("IOTWEBCONF_EEPROM_FILE", "/dev/null", 1);
+
+  bool failed = false;
+  printf("Config post and save, microseconds per post (%d posts):\n", posts);
+  for (int fields : { 50, 200, 500 })
+  {
+    double linear = measure(fields, false, posts);
+    double indexed = measure(fields, true, posts);
+    if ((linear < 0) || (indexed < 0))
+    {
+      printf("  %3d fields: post was not saved\n", fields);
+      failed = true;
+      continue;
+    }
+    printf("  %3d fields: looked up one by one %7.1f us, indexed %7.1f us\n",
+      fields, linear, indexed);
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,339 @@
+/**
+ * Arduino.cpp -- Minimal Arduino core for running IotWebConf on a host
+ *   computer (see host/README.md).
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <IPAddress.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/random.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+WiFiClass WiFi;
+HostClock hostClock;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t monotonicMicros()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+// -- Counted from the start of the program, like on the device.
+static const uint64_t startMicros = monotonicMicros();
+
+unsigned long millis()
+{
+  return micros() / 1000;
+}
+
+unsigned long micros()
+{
+  if (hostClock.simulated)
+  {
+    return hostClock.now;
+  }
+  return monotonicMicros() - startMicros;
+}
+
+void delay(unsigned long ms)
+{
+  if (hostClock.simulated)
+  {
+    hostClock.now += (uint64_t)ms * 1000;
+    hostClock.idle += (uint64_t)ms * 1000;
+    return;
+  }
+  usleep(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  if (hostClock.simulated)
+  {
+    hostClock.spend(us);
+    return;
+  }
+  usleep(us);
+}
+
+void yield()
+{
+  if (hostClock.simulated)
+  {
+    hostClock.spend(1);
+  }
+}
+
+uint32_t esp_random()
+{
+  uint32_t value = 0;
+  while (getrandom(&value, sizeof(value), 0) != sizeof(value))
+  {
+  }
+  return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string formatUnsigned(unsigned long long value, unsigned char base)
+{
+  char buffer[66];
+  char* p = buffer + sizeof(buffer) - 1;
+  *p = '\0';
+  if (base < 2)
+  {
+    base = 10;
+  }
+  do
+  {
+    int digit = value % base;
+    *--p = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    value /= base;
+  } while (value > 0);
+  return std::string(p);
+}
+
+String::String(long value, unsigned char base) :
+  String((long long)value, base) { }
+
+String::String(unsigned long value, unsigned char base) :
+  String((unsigned long long)value, base) { }
+
+String::String(long long value, unsigned char base)
+{
+  if ((value < 0) && (base == DEC))
+  {
+    this->_s = "-" + formatUnsigned(-(unsigned long long)value, base);
+  }
+  else
+  {
+    this->_s = formatUnsigned(value, base);
+  }
+}
+
+String::String(unsigned long long value, unsigned char base) :
+  _s(formatUnsigned(value, base)) { }
+
+String::String(double value, unsigned char decimalPlaces)
+{
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "%.*f", decimalPlaces, value);
+  this->_s = buffer;
+}
+
+void String::replace(const String& find, const String& replace)
+{
+  if (find._s.empty())
+  {
+    return;
+  }
+  size_t position = 0;
+  while ((position = this->_s.find(find._s, position)) != std::string::npos)
+  {
+    this->_s.replace(position, find._s.length(), replace._s);
+    position += replace._s.length();
+  }
+}
+
+void String::trim()
+{
+  size_t begin = 0;
+  while ((begin < this->_s.length()) && isspace(this->_s[begin]))
+  {
+    begin++;
+  }
+  size_t end = this->_s.length();
+  while ((end > begin) && isspace(this->_s[end - 1]))
+  {
+    end--;
+  }
+  this->_s = this->_s.substr(begin, end - begin);
+}
+
+void String::getBytes(
+  unsigned char* buffer, unsigned int size, unsigned int index) const
+{
+  if (size == 0)
+  {
+    return;
+  }
+  size_t length = 0;
+  if (index < this->_s.length())
+  {
+    length = std::min((size_t)size - 1, this->_s.length() - index);
+    memcpy(buffer, this->_s.data() + index, length);
+  }
+  buffer[length] = '\0';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool IPAddress::fromString(const char* address)
+{
+  struct in_addr parsed;
+  if (inet_pton(AF_INET, address, &parsed) != 1)
+  {
+    return false;
+  }
+  memcpy(this->_bytes, &parsed.s_addr, 4);
+  return true;
+}
+
+String IPAddress::toString() const
+{
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u",
+    this->_bytes[0], this->_bytes[1], this->_bytes[2], this->_bytes[3]);
+  return String(buffer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const char* EEPROMClass::path()
+{
+  const char* path = getenv("IOTWEBCONF_EEPROM_FILE");
+  return path == NULL ? "eeprom.bin" : path;
+}
+
+void EEPROMClass::begin(size_t size)
+{
+  // -- Never written cells of an EEPROM read as 0xFF.
+  this->_data.assign(size, 0xFF);
+  FILE* file = fopen(this->path(), "rb");
+  if (file != NULL)
+  {
+    size_t read = fread(this->_data.data(), 1, size, file);
+    (void)read;
+    fclose(file);
+  }
+}
+
+bool EEPROMClass::commit()
+{
+  FILE* file = fopen(this->path(), "wb");
+  if (file == NULL)
+  {
+    return false;
+  }
+  bool result =
+    fwrite(this->_data.data(), 1, this->_data.size(), file) == this->_data.size();
+  return (fclose(file) == 0) && result;
+}
+
+bool EEPROMClass::end()
+{
+  bool result = this->commit();
+  this->_data.clear();
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint8_t WiFiUDP::begin(uint16_t port)
+{
+  this->stop();
+  this->_fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (this->_fd < 0)
+  {
+    return 0;
+  }
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  // -- Default buffer holds only a few hundred small datagrams, that a
+  //    storm of queries overflows (see iotwebconf-storm).
+  int bufferSize = 1 << 20;
+  setsockopt(this->_fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+  int flags = fcntl(this->_fd, F_GETFL, 0);
+  if ((bind(this->_fd, (struct sockaddr*)&address, sizeof(address)) != 0)
+    || (fcntl(this->_fd, F_SETFL, flags | O_NONBLOCK) != 0))
+  {
+    this->stop();
+    return 0;
+  }
+  return 1;
+}
+
+void WiFiUDP::stop()
+{
+  if (this->_fd >= 0)
+  {
+    close(this->_fd);
+    this->_fd = -1;
+  }
+}
+
+int WiFiUDP::parsePacket()
+{
+  if (this->_fd < 0)
+  {
+    return 0;
+  }
+  this->_received.resize(1500);
+  struct sockaddr_in address;
+  socklen_t addressLength = sizeof(address);
+  ssize_t length = recvfrom(this->_fd, this->_received.data(),
+    this->_received.size(), 0, (struct sockaddr*)&address, &addressLength);
+  if (length <= 0)
+  {
+    this->_received.clear();
+    return 0;
+  }
+  this->_received.resize(length);
+  this->_readPosition = 0;
+  this->_remoteIp = address.sin_addr.s_addr;
+  this->_remotePort = ntohs(address.sin_port);
+  return length;
+}
+
+int WiFiUDP::read(uint8_t* buffer, size_t size)
+{
+  size_t length = std::min(size, (size_t)this->available());
+  memcpy(buffer, this->_received.data() + this->_readPosition, length);
+  this->_readPosition += length;
+  return length;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port)
+{
+  this->_sending.clear();
+  this->_sendIp = ip;
+  this->_sendPort = port;
+  return 1;
+}
+
+size_t WiFiUDP::write(const uint8_t* buffer, size_t size)
+{
+  this->_sending.insert(this->_sending.end(), buffer, buffer + size);
+  return size;
+}
+
+int WiFiUDP::endPacket()
+{
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(this->_sendPort);
+  address.sin_addr.s_addr = this->_sendIp;
+  ssize_t sent = sendto(this->_fd, this->_sending.data(), this->_sending.size(),
+    0, (struct sockaddr*)&address, sizeof(address));
+  return sent == (ssize_t)this->_sending.size() ? 1 : 0;
+}
@@ -0,0 +1,244 @@
+/**
+ * Arduino.h -- Minimal Arduino core for running IotWebConf on a host
+ *   computer (see host/README.md). Only the parts used by IotWebConf are
+ *   provided.
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfHostArduino_h
+#define IotWebConfHostArduino_h
+
+#include <ctype.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// -- There is no separate flash memory on the host.
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper*>(p))
+
+#define DEC 10
+#define HEX 16
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+/**
+ * Simulated time, for measuring CPU use without the noise of the host (see
+ * IotWebConfIdle.cpp). While 'simulated' is set, millis() and micros()
+ * return 'now'. delay() moves it on as idle time, delayMicroseconds() and
+ * yield() (1 us) as busy time. Programs simulate their own work by spend().
+ */
+struct HostClock
+{
+  bool simulated = false;
+  uint64_t now = 0;
+  uint64_t busy = 0;
+  uint64_t idle = 0;
+  void spend(uint64_t us) { this->now += us; this->busy += us; };
+};
+extern HostClock hostClock;
+// -- Random numbers of the kernel, in place of the hardware generator.
+uint32_t esp_random();
+
+/**
+ * Arduino String on top of std::string.
+ */
+class String
+{
+public:
+  String() { };
+  String(const char* value) { if (value != NULL) { this->_s = value; } };
+  String(const __FlashStringHelper* value) :
+    String(reinterpret_cast<const char*>(value)) { };
+  String(const std::string& value) : _s(value) { };
+  explicit String(char value) : _s(1, value) { };
+  explicit String(unsigned char value, unsigned char base = DEC) :
+    String((unsigned long)value, base) { };
+  explicit String(int value, unsigned char base = DEC) :
+    String((long)value, base) { };
+  explicit String(unsigned int value, unsigned char base = DEC) :
+    String((unsigned long)value, base) { };
+  explicit String(long value, unsigned char base = DEC);
+  explicit String(unsigned long value, unsigned char base = DEC);
+  explicit String(long long value, unsigned char base = DEC);
+  explicit String(unsigned long long value, unsigned char base = DEC);
+  explicit String(float value, unsigned char decimalPlaces = 2) :
+    String((double)value, decimalPlaces) { };
+  explicit String(double value, unsigned char decimalPlaces = 2);
+
+  unsigned int length() const { return this->_s.length(); };
+  bool isEmpty() const { return this->_s.empty(); };
+  const char* c_str() const { return this->_s.c_str(); };
+  bool reserve(unsigned int size) { this->_s.reserve(size); return true; };
+
+  bool concat(const String& value) { this->_s += value._s; return true; };
+  bool concat(const char* value) { if (value != NULL) { this->_s += value; } return true; };
+  bool concat(const char* value, unsigned int length) { this->_s.append(value, length); return true; };
+  bool concat(const __FlashStringHelper* value) { return this->concat(reinterpret_cast<const char*>(value)); };
+  bool concat(char value) { this->_s += value; return true; };
+  template <typename T> bool concat(T value) { return this->concat(String(value)); };
+  template <typename T> String& operator+=(T value) { this->concat(value); return *this; };
+
+  char charAt(unsigned int index) const { return index < this->_s.length() ? this->_s[index] : 0; };
+  void setCharAt(unsigned int index, char c) { if (index < this->_s.length()) { this->_s[index] = c; } };
+  char operator[](unsigned int index) const { return this->charAt(index); };
+  char& operator[](unsigned int index) { return this->_s[index]; };
+
+  int compareTo(const String& other) const { return this->_s.compare(other._s); };
+  bool equals(const String& other) const { return this->_s == other._s; };
+  bool equals(const char* other) const { return this->_s == (other == NULL ? "" : other); };
+  bool equalsIgnoreCase(const String& other) const
+  {
+    return (this->_s.length() == other._s.length())
+      && (strcasecmp(this->c_str(), other.c_str()) == 0);
+  };
+  bool startsWith(const String& prefix) const { return this->_s.compare(0, prefix._s.length(), prefix._s) == 0; };
+  bool endsWith(const String& suffix) const
+  {
+    return (this->_s.length() >= suffix._s.length())
+      && (this->_s.compare(this->_s.length() - suffix._s.length(), suffix._s.length(), suffix._s) == 0);
+  };
+  bool operator==(const String& other) const { return this->equals(other); };
+  bool operator==(const char* other) const { return this->equals(other); };
+  bool operator!=(const String& other) const { return !this->equals(other); };
+  bool operator!=(const char* other) const { return !this->equals(other); };
+  bool operator<(const String& other) const { return this->_s < other._s; };
+
+  int indexOf(char c, unsigned int from = 0) const { return position(this->_s.find(c, from)); };
+  int indexOf(const String& value, unsigned int from = 0) const { return position(this->_s.find(value._s, from)); };
+  int lastIndexOf(char c) const { return position(this->_s.rfind(c)); };
+  int lastIndexOf(const String& value) const { return position(this->_s.rfind(value._s)); };
+  String substring(unsigned int from) const { return this->substring(from, this->_s.length()); };
+  String substring(unsigned int from, unsigned int to) const
+  {
+    if (from > to) { std::swap(from, to); }
+    if (from >= this->_s.length()) { return String(); }
+    return String(this->_s.substr(from, to - from));
+  };
+
+  void replace(char find, char replace) { std::replace(this->_s.begin(), this->_s.end(), find, replace); };
+  void replace(const String& find, const String& replace);
+  void remove(unsigned int index) { if (index < this->_s.length()) { this->_s.erase(index); } };
+  void remove(unsigned int index, unsigned int count) { if (index < this->_s.length()) { this->_s.erase(index, count); } };
+  void toLowerCase() { for (char& c : this->_s) { c = tolower(c); } };
+  void toUpperCase() { for (char& c : this->_s) { c = toupper(c); } };
+  void trim();
+
+  long toInt() const { return atol(this->c_str()); };
+  float toFloat() const { return atof(this->c_str()); };
+  double toDouble() const { return atof(this->c_str()); };
+  void toCharArray(char* buffer, unsigned int size, unsigned int index = 0) const
+  {
+    this->getBytes((unsigned char*)buffer, size, index);
+  };
+  void getBytes(unsigned char* buffer, unsigned int size, unsigned int index = 0) const;
+
+private:
+  std::string _s;
+
+  static int position(size_t p) { return p == std::string::npos ? -1 : (int)p; };
+};
+
+inline String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+inline String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, const __FlashStringHelper* b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, char b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, int b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, unsigned int b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, long b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, unsigned long b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, double b) { String r(a); r += b; return r; }
+
+class Print;
+
+class Printable
+{
+public:
+  virtual size_t printTo(Print& p) const = 0;
+};
+
+class Print
+{
+public:
+  virtual ~Print() { };
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size)
+  {
+    size_t n = 0;
+    while (size--) { n += this->write(*buffer++); }
+    return n;
+  };
+  size_t write(const char* s) { return s == NULL ? 0 : this->write((const uint8_t*)s, strlen(s)); };
+  size_t write(const char* buffer, size_t size) { return this->write((const uint8_t*)buffer, size); };
+  virtual void flush() { };
+
+  size_t print(const String& s) { return this->write(s.c_str(), s.length()); };
+  size_t print(const char* s) { return this->write(s); };
+  size_t print(const __FlashStringHelper* s) { return this->write(reinterpret_cast<const char*>(s)); };
+  size_t print(char c) { return this->write((uint8_t)c); };
+  size_t print(const Printable& p) { return p.printTo(*this); };
+  size_t print(double value, int digits = 2) { return this->print(String(value, digits)); };
+  template <typename T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
+  size_t print(T value, int base = DEC) { return this->print(String(value, base)); };
+
+  size_t println() { return this->write("\r\n"); };
+  template <typename T> size_t println(T value) { size_t n = this->print(value); return n + this->println(); };
+  template <typename T> size_t println(T value, int format) { size_t n = this->print(value, format); return n + this->println(); };
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+/**
+ * Serial is written to the standard output.
+ */
+class HardwareSerial : public Stream
+{
+public:
+  void begin(unsigned long baud) { };
+  size_t write(uint8_t c) override { return fwrite(&c, 1, 1, stdout); };
+  size_t write(const uint8_t* buffer, size_t size) override { return fwrite(buffer, 1, size, stdout); };
+  int available() override { return 0; };
+  int read() override { return -1; };
+  int peek() override { return -1; };
+  void flush() override { fflush(stdout); };
+  operator bool() { return true; };
+};
+
+extern HardwareSerial Serial;
+
+#endif
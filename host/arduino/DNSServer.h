@@ -0,0 +1,27 @@
+/**
+ * DNSServer.h -- Minimal Arduino core for running IotWebConf on a host
+ *   computer (see host/README.md).
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfHostDNSServer_h
+#define IotWebConfHostDNSServer_h
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+/**
+ * Interface only, use CaptiveDnsServer on the host.
+ */
+class DNSServer
+{
+public:
+  bool start(uint16_t port, const String& domainName, const IPAddress& ip) { return false; };
+  void stop() { };
+  void setTTL(uint32_t ttl) { };
+  void processNextRequest() { };
+};
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * EEPROM.h -- Minimal Arduino core for running IotWebConf on a host
+ *   computer (see host/README.md).
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfHostEEPROM_h
+#define IotWebConfHostEEPROM_h
+
+#include <Arduino.h>
+#include <vector>
+
+/**
+ * EEPROM emulation kept in a file, so that the configuration survives a
+ * restart. The file is "eeprom.bin" in the working directory, or the one
+ * given in the IOTWEBCONF_EEPROM_FILE environment variable.
+ */
+class EEPROMClass
+{
+public:
+  void begin(size_t size);
+  uint8_t read(int address) { return address < (int)this->_data.size() ? this->_data[address] : 0xFF; };
+  void write(int address, uint8_t value) { if (address < (int)this->_data.size()) { this->_data[address] = value; } };
+  bool commit();
+  bool end();
+  size_t length() { return this->_data.size(); };
+
+private:
+  std::vector<uint8_t> _data;
+  const char* path();
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * IPAddress.h -- Minimal Arduino core for running IotWebConf on a host
+ *   computer (see host/README.md).
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfHostIPAddress_h
+#define IotWebConfHostIPAddress_h
+
+#include <Arduino.h>
+
+/**
+ * IPv4 address, stored in network byte order (as on the ESP).
+ */
+class IPAddress : public Printable
+{
+public:
+  IPAddress() { };
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+  {
+    this->_bytes[0] = a;
+    this->_bytes[1] = b;
+    this->_bytes[2] = c;
+    this->_bytes[3] = d;
+  };
+  IPAddress(uint32_t address) { memcpy(this->_bytes, &address, 4); };
+
+  operator uint32_t() const
+  {
+    uint32_t address;
+    memcpy(&address, this->_bytes, 4);
+    return address;
+  };
+  uint8_t operator[](int index) const { return this->_bytes[index]; };
+  uint8_t& operator[](int index) { return this->_bytes[index]; };
+
+  bool fromString(const char* address);
+  bool fromString(const String& address) { return this->fromString(address.c_str()); };
+  String toString() const;
+  size_t printTo(Print& p) const override { return p.print(this->toString()); };
+
+private:
+  uint8_t _bytes[4] = { 0, 0, 0, 0 };
+};
+
+#endif
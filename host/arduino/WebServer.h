@@ -0,0 +1,55 @@
+/**
+ * WebServer.h -- Minimal Arduino core for running IotWebConf on a host
+ *   computer (see host/README.md).
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfHostWebServer_h
+#define IotWebConfHostWebServer_h
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
+#define CONTENT_LENGTH_NOT_SET ((size_t) -2)
+
+enum HTTPAuthMethod { BASIC_AUTH, DIGEST_AUTH };
+
+/**
+ * Interface only, so that the standard wrappers of IotWebConf compile. It
+ * never receives any request, use AsyncWebServerWrapper with a transport
+ * of the host folder instead.
+ */
+class WebServer
+{
+public:
+  WebServer(int port = 80) { };
+
+  void begin() { };
+  void handleClient() { };
+  void on(const String& uri, std::function<void()> handler) { };
+  void onNotFound(std::function<void()> handler) { };
+
+  String hostHeader() { return String(); };
+  String uri() { return String(); };
+  WiFiClient client() { return WiFiClient(); };
+  bool authenticate(const char* username, const char* password) { return false; };
+  void requestAuthentication(HTTPAuthMethod mode = BASIC_AUTH) { };
+  bool hasArg(const String& name) { return false; };
+  String arg(const String& name) { return String(); };
+  String arg(int i) { return String(); };
+  String argName(int i) { return String(); };
+  int args() { return 0; };
+  void collectHeaders(const char* headerKeys[], const size_t headerKeysCount) { };
+  String header(const String& name) { return String(); };
+  void sendHeader(const String& name, const String& value, bool first = false) { };
+  void setContentLength(size_t contentLength) { };
+  void send(int code, const char* contentType = NULL, const String& content = String("")) { };
+  void send_P(int code, PGM_P contentType, PGM_P content, size_t length) { };
+  void sendContent(const String& content) { };
+  void sendContent_P(PGM_P content, size_t size) { };
+};
+
+#endif
@@ -0,0 +1,51 @@
+/**
+ * WiFi.h -- Minimal Arduino core for running IotWebConf on a host
+ *   computer (see host/README.md).
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfHostWiFi_h
+#define IotWebConfHostWiFi_h
+
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <WiFiUdp.h>
+
+/**
+ * The host is considered to be connected to a network all the time, and to
+ * have a station connected to its AP (so that the portal is never idle, see
+ * IOTWEBCONF_PORTAL_HEARTBEAT_MILLIS), unless stationNum is changed.
+ */
+class WiFiClass
+{
+public:
+  uint8_t stationNum = 1;
+
+  bool setHostname(const char* hostname) { this->_hostname = hostname; return true; };
+  bool hostname(const char* hostname) { return this->setHostname(hostname); };
+  const char* getHostname() { return this->_hostname.c_str(); };
+  IPAddress localIP() { return IPAddress(127, 0, 0, 1); };
+  IPAddress softAPIP() { return IPAddress(127, 0, 0, 1); };
+  uint8_t softAPgetStationNum() { return this->stationNum; };
+
+private:
+  String _hostname;
+};
+
+extern WiFiClass WiFi;
+
+/**
+ * Only the parts used through the WebServer interface.
+ */
+class WiFiClient
+{
+public:
+  IPAddress localIP() { return IPAddress(127, 0, 0, 1); };
+  void stop() { };
+  bool connected() { return false; };
+  size_t write(const uint8_t* buffer, size_t size) { return 0; };
+};
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * WiFiUdp.h -- Minimal Arduino core for running IotWebConf on a host
+ *   computer (see host/README.md).
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfHostWiFiUdp_h
+#define IotWebConfHostWiFiUdp_h
+
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <vector>
+
+/**
+ * UDP over a non-blocking socket, so that CaptiveDnsServer can be run on the
+ * host (use a port above 1024 for not needing root).
+ */
+class WiFiUDP
+{
+public:
+  ~WiFiUDP() { this->stop(); };
+
+  uint8_t begin(uint16_t port);
+  void stop();
+  int parsePacket();
+  int read(uint8_t* buffer, size_t size);
+  int available() { return this->_received.size() - this->_readPosition; };
+  IPAddress remoteIP() { return IPAddress(this->_remoteIp); };
+  uint16_t remotePort() { return this->_remotePort; };
+
+  int beginPacket(IPAddress ip, uint16_t port);
+  size_t write(const uint8_t* buffer, size_t size);
+  int endPacket();
+
+private:
+  int _fd = -1;
+  std::vector<uint8_t> _received;
+  size_t _readPosition = 0;
+  uint32_t _remoteIp = 0;
+  uint16_t _remotePort = 0;
+  std::vector<uint8_t> _sending;
+  uint32_t _sendIp = 0;
+  uint16_t _sendPort = 0;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#!/bin/sh
+#
+# Builds the programs of this folder for a Linux host: ./build.sh [g++ options]
+#   E.g. ./build.sh -O0 -fsanitize=address for debugging, or
+#   ./build.sh -DIOTWEBCONF_ASYNC_MAX_CLIENTS=8 to try other settings.
+#   iotwebconf-host - The config portal, see README.md.
+#   iotwebconf-storm - Benchmark of many clients connecting at once.
+#   iotwebconf-numbers - Round trip check and benchmark of number parsing.
+#   iotwebconf-idle - CPU use of the library with little to do.
+#   iotwebconf-posts - Benchmark of config posts with many fields.
+#
+# The Arduino shims of the "arduino" folder mimic the ESP32 core, hence
+# ESP32 is defined. Serial debug output is disabled, as it would dominate
+# any load test (add -UIOTWEBCONF_DEBUG_DISABLED to get it back).
+
+set -e
+cd "$(dirname "$0")"
+CXXFLAGS="-std=gnu++17 -O2 -g -Wall -Wno-unused-variable
+  -DESP32 -DIOTWEBCONF_CONFIG_DONT_USE_MDNS -DIOTWEBCONF_DEBUG_DISABLED
+  -Iarduino -I. -I../src"
+
+# -- Library and shims are compiled once for all programs.
+mkdir -p build
+objects=""
+for source in ../src/*.cpp arduino/*.cpp IotWebConf*Transport.cpp
+do
+  object="build/$(basename "$source" .cpp).o"
+  ${CXX:-g++} $CXXFLAGS "$@" -c "$source" -o "$object"
+  objects="$objects $object"
+done
+
+${CXX:-g++} $CXXFLAGS "$@" IotWebConfHost.cpp $objects -o iotwebconf-host
+${CXX:-g++} $CXXFLAGS "$@" IotWebConfStorm.cpp $objects -pthread \
+  -o iotwebconf-storm
+${CXX:-g++} $CXXFLAGS "$@" IotWebConfNumbers.cpp $objects -o iotwebconf-numbers
+${CXX:-g++} $CXXFLAGS "$@" IotWebConfIdle.cpp $objects -o iotwebconf-idle
+${CXX:-g++} $CXXFLAGS "$@" IotWebConfPosts.cpp $objects -o iotwebconf-posts
+echo "Built $(pwd)/iotwebconf-host, $(pwd)/iotwebconf-storm," \
+  "$(pwd)/iotwebconf-numbers, $(pwd)/iotwebconf-idle and" \
+  "$(pwd)/iotwebconf-posts"
@@ -0,0 +1,42 @@
+#!/bin/bash
+#
+# This script will compress portal.html and generate the C header
+# ../src/IotWebConfSpa.h containing the gzipped page as a PROGMEM array.
+# Run it every time portal.html was modified.
+#
+cd `dirname $0`
+target="../src/IotWebConfSpa.h"
+
+gzip -9 -n -c portal.html > portal.html.gz
+size=`wc -c < portal.html.gz`
+
+cat > ${target} << HEADER
+/**
+ * IotWebConfSpa.h -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+// -- This file is generated by spa/build-spa.sh from spa/portal.html,
+//    do not edit it by hand!
+
+#ifndef IotWebConfSpa_h
+#define IotWebConfSpa_h
+
+#include <Arduino.h>
+
+const size_t IOTWEBCONF_SPA_GZ_LENGTH = ${size};
+const uint8_t IOTWEBCONF_SPA_GZ[] PROGMEM = {
+HEADER
+xxd -i < portal.html.gz >> ${target}
+cat >> ${target} << FOOTER
+};
+
+#endif
+FOOTER
+rm portal.html.gz
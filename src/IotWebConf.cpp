@@ -12,6 +12,7 @@
 #include <EEPROM.h>
 
 #include "IotWebConf.h"
+#include "IotWebConfSpa.h"
 
 #ifdef IOTWEBCONF_CONFIG_USE_MDNS
 # ifdef ESP8266
@@ -28,7 +29,7 @@ namespace iotwebconf
 {
 
 IotWebConf::IotWebConf(
-    const char* defaultThingName, DNSServer* dnsServer, WebServerWrapper* webServerWrapper,
+    const char* defaultThingName, DnsServerWrapper* dnsServer, WebServerWrapper* webServerWrapper,
     const char* initialApPassword, const char* configVersion)
 {
   this->_thingNameParameter.defaultValue = defaultThingName;
@@ -37,6 +38,14 @@ IotWebConf::IotWebConf(
   this->_initialApPassword = initialApPassword;
   this->_configVersion = configVersion;
 
+  this->_thingNameParameter.constraints.required = true;
+  this->_thingNameParameter.constraints.minLength = 3;
+  this->_thingNameParameter.constraints.errorMessage =
+      "Give a name with at least 3 characters.";
+  this->_apPasswordParameter.constraints.minLength = 8;
+  this->_apPasswordParameter.constraints.errorMessage =
+      "Password length must be at least 8 characters.";
+
   this->_systemParameters.addItem(&this->_thingNameParameter);
   this->_systemParameters.addItem(&this->_apPasswordParameter);
 
@@ -44,6 +53,9 @@ IotWebConf::IotWebConf(
   this->_allParameters.addItem(&this->_customParameterGroups);
   this->_allParameters.addItem(&this->_hiddenParameters);
 
+  this->_loopScheduler.addTask(&this->_dnsLoopTask);
+  this->_loopScheduler.addTask(&this->_httpLoopTask);
+
 }
 
 char* IotWebConf::getThingName()
@@ -77,6 +89,18 @@ bool IotWebConf::init()
   return validConfig;
 }
 
+void IotWebConf::setSessionAuth(bool sessionAuth)
+{
+  this->_sessionAuth = sessionAuth;
+  this->_sessions.clear();
+  if (sessionAuth
+    && (this->_webServerWrapper == &this->_standardWebServerWrapper))
+  {
+    static const char* headerKeys[] = { "Cookie" };
+    this->_standardWebServerWrapper._server->collectHeaders(headerKeys, 1);
+  }
+}
+
 //////////////////////////////////////////////////////////////////
 
 void IotWebConf::addParameterGroup(ParameterGroup* group)
@@ -169,6 +193,9 @@ void IotWebConf::saveConfig()
 
   EEPROM.end();
 
+  // -- Password might have been changed, all browsers must log in again.
+  this->_sessions.clear();
+
   if (this->_configSavedCallback != NULL)
   {
     this->_configSavedCallback();
@@ -186,7 +213,12 @@ void IotWebConf::writeEepromValue(int start, byte* valueBuffer, int length)
 {
   for (int t = 0; t < length; t++)
   {
-    EEPROM.write(start + t, *((char*)valueBuffer + t));
+    // -- Only changed bytes are written, so storage is not marked as dirty
+    //    by items left untouched (e.g. by a partial update).
+    if (EEPROM.read(start + t) != *((byte*)valueBuffer + t))
+    {
+      EEPROM.write(start + t, *((char*)valueBuffer + t));
+    }
   }
 }
 
@@ -204,10 +236,9 @@ bool IotWebConf::testConfigVersion()
 
 void IotWebConf::saveConfigVersion()
 {
-  for (byte t = 0; t < IOTWEBCONF_CONFIG_VERSION_LENGTH; t++)
-  {
-    EEPROM.write(IOTWEBCONF_CONFIG_START + t, this->_configVersion[t]);
-  }
+  this->writeEepromValue(
+    IOTWEBCONF_CONFIG_START, (byte*)this->_configVersion,
+    IOTWEBCONF_CONFIG_VERSION_LENGTH);
 }
 
 void IotWebConf::setConfigSavingCallback(std::function<void(int size)> func)
@@ -229,66 +260,122 @@ void IotWebConf::setFormValidator(
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void IotWebConf::handleConfig(WebRequestWrapper* webRequestWrapper)
+static const char sessionCookieName[] = "IWCSESSION";
+
+/**
+ * Returns the value of a cookie in a Cookie header (running till the next
+ * ';'), or NULL if the cookie is not present.
+ */
+static const char* findCookie(const char* cookies, const char* name)
 {
-    // -- Authenticate
-    if (!webRequestWrapper->authenticate(
-            IOTWEBCONF_ADMIN_USER_NAME, this->_apPassword))
+  size_t nameLength = strlen(name);
+  const char* cookie = cookies;
+  while (cookie != NULL)
+  {
+    while (*cookie == ' ')
     {
-      IOTWEBCONF_DEBUG_LINE(F("Requesting authentication."));
-      webRequestWrapper->requestAuthentication();
-      return;
+      cookie++;
+    }
+    if ((strncmp(cookie, name, nameLength) == 0) && (cookie[nameLength] == '='))
+    {
+      return cookie + nameLength + 1;
     }
+    cookie = strchr(cookie, ';');
+    if (cookie != NULL)
+    {
+      cookie++;
+    }
+  }
+  return NULL;
+}
 
-  bool dataArrived = webRequestWrapper->hasArg("iotSave");
-  if (!dataArrived || !this->validateForm(webRequestWrapper))
+/**
+ * Returns true, if the request carries a valid session token, or the right
+ * credentials. Otherwise authentication is requested from the client, and
+ * the request should not be served.
+ */
+bool IotWebConf::authenticate(WebRequestWrapper* webRequestWrapper)
+{
+  if (this->_sessionAuth)
   {
-    // -- Display config portal
-    IOTWEBCONF_DEBUG_LINE(F("Configuration page requested."));
+    String cookie = webRequestWrapper->header("Cookie");
+    const char* token = findCookie(cookie.c_str(), sessionCookieName);
+    if ((token != NULL)
+      && this->_sessions.validate(token, strcspn(token, "; "), millis()))
+    {
+      return true;
+    }
+  }
 
-    // Send chunked output instead of one String, to avoid
-    // filling memory if using many parameters.
-    webRequestWrapper->sendHeader(
-        "Cache-Control", "no-cache, no-store, must-revalidate");
-    webRequestWrapper->sendHeader("Pragma", "no-cache");
-    webRequestWrapper->sendHeader("Expires", "-1");
-    webRequestWrapper->setContentLength(CONTENT_LENGTH_UNKNOWN);
-    webRequestWrapper->send(200, "text/html; charset=UTF-8", "");
+  if (!webRequestWrapper->authenticate(
+          IOTWEBCONF_ADMIN_USER_NAME, this->_apPassword))
+  {
+    IOTWEBCONF_DEBUG_LINE(F("Requesting authentication."));
+    webRequestWrapper->requestAuthentication();
+    return false;
+  }
 
-    String content = htmlFormatProvider->getHead();
-    content.replace("{v}", "Config ESP");
-    content += htmlFormatProvider->getScript();
-    content += htmlFormatProvider->getStyle();
-    content += htmlFormatProvider->getHeadExtension();
-    content += htmlFormatProvider->getHeadEnd();
+  if (this->_sessionAuth)
+  {
+    IOTWEBCONF_DEBUG_LINE(F("Opening session."));
+    char token[IOTWEBCONF_SESSION_TOKEN_HEX_LENGTH + 1];
+    this->_sessions.open(millis(), token);
+    String cookie(sessionCookieName);
+    cookie += '=';
+    cookie += token;
+    cookie += F("; Path=/; HttpOnly; SameSite=Strict");
+    webRequestWrapper->sendHeader("Set-Cookie", cookie.c_str());
+  }
+  return true;
+}
 
-    content += htmlFormatProvider->getFormStart();
+void IotWebConf::handleConfig(WebRequestWrapper* webRequestWrapper)
+{
+  if (!this->authenticate(webRequestWrapper))
+  {
+    return;
+  }
 
-    webRequestWrapper->sendContent(content);
+  if (this->_clientRenderedPortal)
+  {
+    this->serveClientRenderedConfig(webRequestWrapper);
+    return;
+  }
+  if (webRequestWrapper->hasArg("iotGroup"))
+  {
+    this->serveConfigGroup(webRequestWrapper);
+    return;
+  }
+
+  // -- Arguments are looked up by every config item (on validation, update
+  //    and rendering), so these are indexed first.
+  IndexedWebRequestWrapper indexedWebRequestWrapper(webRequestWrapper);
+  webRequestWrapper = &indexedWebRequestWrapper;
+
+  bool dataArrived = webRequestWrapper->hasArg("iotSave");
+  if (dataArrived && webRequestWrapper->hasArg("iotAjax"))
+  {
+    // -- Form was posted by the script of the page, only the result is
+    //    sent back.
+    this->postConfig(webRequestWrapper, webRequestWrapper);
+    return;
+  }
+  if (!dataArrived || !this->validateForm(webRequestWrapper))
+  {
+    // -- Display config portal
+    IOTWEBCONF_DEBUG_LINE(F("Configuration page requested."));
 
 #ifdef IOTWEBCONF_DEBUG_TO_SERIAL
     Serial.println("Rendering parameters:");
     this->_systemParameters.debugTo(&Serial);
     this->_customParameterGroups.debugTo(&Serial);
 #endif
-    // -- Add parameters to the form
-    this->_systemParameters.renderHtml(dataArrived, webRequestWrapper);
-    this->_customParameterGroups.renderHtml(dataArrived, webRequestWrapper);
-
-    content = htmlFormatProvider->getFormEnd();
-
-    // -- Fill config version string;
-    {
-      String pitem = htmlFormatProvider->getConfigVer();
-      pitem.replace("{v}", this->_configVersion);
-      content += pitem;
-    }
-
-    content += htmlFormatProvider->getEnd();
-
-    webRequestWrapper->sendContent(content);
-    webRequestWrapper->sendContent(F(""));
-    webRequestWrapper->stop();
+    this->sendRendered(
+      webRequestWrapper, "text/html; charset=UTF-8",
+      [&](WebRequestWrapper* target)
+      {
+        this->renderConfigPage(dataArrived, target);
+      });
   }
   else
   {
@@ -299,10 +386,7 @@ void IotWebConf::handleConfig(WebRequestWrapper* webRequestWrapper)
     this->_customParameterGroups.debugTo(&Serial);
     Serial.println();
 #endif
-    this->_systemParameters.update(webRequestWrapper);
-    this->_customParameterGroups.update(webRequestWrapper);
-
-    this->saveConfig();
+    this->applyConfig(webRequestWrapper);
 
     String page = htmlFormatProvider->getHead();
     page.replace("{v}", "Config ESP");
@@ -315,11 +399,385 @@ void IotWebConf::handleConfig(WebRequestWrapper* webRequestWrapper)
     page += F("Return to <a href='/'>home page</a>.");
     page += htmlFormatProvider->getEnd();
 
-    webRequestWrapper->sendHeader("Content-Length", String(page.length()));
+    webRequestWrapper->setContentLength(page.length());
     webRequestWrapper->send(200, "text/html; charset=UTF-8", page);
   }
 }
 
+void IotWebConf::renderConfigPage(
+  bool dataArrived, WebRequestWrapper* webRequestWrapper)
+{
+  String content = htmlFormatProvider->getHead();
+  content.replace("{v}", "Config ESP");
+  content += htmlFormatProvider->getScript();
+  if (this->_lazyGroupLoading)
+  {
+    content += htmlFormatProvider->getLazyGroupScript();
+  }
+  if (this->_ajaxSave)
+  {
+    content += htmlFormatProvider->getAjaxSaveScript();
+  }
+  content += htmlFormatProvider->getStyle();
+  content += htmlFormatProvider->getHeadExtension();
+  content += htmlFormatProvider->getHeadEnd();
+
+  content += htmlFormatProvider->getFormStart();
+
+  webRequestWrapper->sendContent(content);
+
+  // -- Add parameters to the form
+  if (this->_systemParameters.renderHtmlBegin(dataArrived, webRequestWrapper))
+  {
+    HtmlRenderCursor systemCursor(&this->_systemParameters, dataArrived);
+    this->renderSliced(&systemCursor, webRequestWrapper);
+    this->_systemParameters.renderHtmlEnd(webRequestWrapper);
+  }
+  HtmlRenderCursor customCursor(
+    &this->_customParameterGroups, dataArrived, this->_lazyGroupLoading);
+  this->renderSliced(&customCursor, webRequestWrapper);
+
+  content = htmlFormatProvider->getFormEnd();
+
+  // -- Fill config version string;
+  {
+    String pitem = htmlFormatProvider->getConfigVer();
+    pitem.replace("{v}", this->_configVersion);
+    content += pitem;
+  }
+
+  content += htmlFormatProvider->getEnd();
+
+  webRequestWrapper->sendContent(content);
+}
+
+void IotWebConf::renderSliced(
+  HtmlRenderCursor* cursor, WebRequestWrapper* webRequestWrapper)
+{
+  unsigned long sliceStart = micros();
+  int sliceItems = 0;
+  while (cursor->renderNext(webRequestWrapper))
+  {
+    sliceItems++;
+    if ((sliceItems >= IOTWEBCONF_HTML_RENDER_SLICE_ITEMS)
+      || (micros() - sliceStart >= IOTWEBCONF_HTML_RENDER_SLICE_MICROS))
+    {
+      if (this->_renderSlicing)
+      {
+        // -- The web server is busy with this request until the whole page
+        //    is sent, but DNS and the other loop tasks can be served
+        //    meanwhile.
+        yield();
+        this->_loopScheduler.runNestedPass(
+          this->_loopBudgetMicros, &this->_httpLoopTask);
+      }
+      else
+      {
+        this->_renderSliceNeeded = true;
+      }
+      sliceStart = micros();
+      sliceItems = 0;
+    }
+  }
+}
+
+void IotWebConf::serveConfigGroup(WebRequestWrapper* webRequestWrapper)
+{
+  String id = webRequestWrapper->arg("iotGroup");
+  ParameterGroup* group = this->_systemParameters.findGroup(id.c_str());
+  if (group == NULL)
+  {
+    group = this->_customParameterGroups.findGroup(id.c_str());
+  }
+  if (group == NULL)
+  {
+    String message = "Unknown group.";
+    webRequestWrapper->setContentLength(message.length());
+    webRequestWrapper->send(404, "text/plain", message);
+    return;
+  }
+
+#ifdef IOTWEBCONF_DEBUG_TO_SERIAL
+  Serial.print(F("Configuration group requested: "));
+  Serial.println(id);
+#endif
+  // -- Only the items are sent, group frame is already on the page.
+  this->sendRendered(
+    webRequestWrapper, "text/html; charset=UTF-8",
+    [&](WebRequestWrapper* target)
+    {
+      group->renderHtmlItems(false, target);
+    });
+}
+
+void IotWebConf::sendRendered(
+  WebRequestWrapper* webRequestWrapper, const char* contentType,
+  std::function<void(WebRequestWrapper* target)> render)
+{
+  webRequestWrapper->sendHeader(
+      "Cache-Control", "no-cache, no-store, must-revalidate");
+  webRequestWrapper->sendHeader("Pragma", "no-cache");
+  webRequestWrapper->sendHeader("Expires", "-1");
+#ifdef IOTWEBCONF_CONFIG_CALCULATE_CONTENT_LENGTH
+  // -- Content is rendered twice: first only to calculate the exact length,
+  //    so that the content can be sent without chunked encoding. No loop
+  //    tasks are run meanwhile (see renderSliced()), as those might change
+  //    the values rendered, and so the length.
+# ifdef IOTWEBCONF_DEBUG_TO_SERIAL
+  unsigned long dryRunStart = micros();
+# endif
+  this->_renderSlicing = false;
+  this->_renderSliceNeeded = false;
+  CountingWebRequestWrapper countingWebRequestWrapper(webRequestWrapper);
+  render(&countingWebRequestWrapper);
+  size_t contentLength = countingWebRequestWrapper.getContentLength();
+  if (!this->_renderSliceNeeded)
+  {
+# ifdef IOTWEBCONF_DEBUG_TO_SERIAL
+    unsigned long renderStart = micros();
+# endif
+    webRequestWrapper->setContentLength(contentLength);
+    webRequestWrapper->send(200, contentType, "");
+    render(webRequestWrapper);
+    this->_renderSlicing = true;
+# ifdef IOTWEBCONF_DEBUG_TO_SERIAL
+    unsigned long renderEnd = micros();
+    Serial.print(F("Sent "));
+    Serial.print(contentLength);
+    Serial.print(F(" bytes. Dry run took "));
+    Serial.print(renderStart - dryRunStart);
+    Serial.print(F("us, rendering took "));
+    Serial.print(renderEnd - renderStart);
+    Serial.println(F("us."));
+# endif
+    return;
+  }
+  // -- Content is long enough to be rendered in slices, with the loop tasks
+  //    run between them. Its length is not known in advance then, so it is
+  //    sent chunked.
+  this->_renderSlicing = true;
+#endif
+  // Send chunked output instead of one String, to avoid
+  // filling memory if using many parameters.
+  webRequestWrapper->setContentLength(CONTENT_LENGTH_UNKNOWN);
+  webRequestWrapper->send(200, contentType, "");
+  render(webRequestWrapper);
+  // -- Last (empty) chunk ends the content, the connection can be reused.
+  webRequestWrapper->sendContent("", 0);
+}
+
+void IotWebConf::handleConfigJson(WebRequestWrapper* webRequestWrapper)
+{
+  if (!this->authenticate(webRequestWrapper))
+  {
+    return;
+  }
+
+  this->serveConfigJson(webRequestWrapper);
+}
+
+void IotWebConf::serveConfigJson(WebRequestWrapper* webRequestWrapper)
+{
+  // -- Arduino WebServer provides non-form request body as "plain".
+  if (!webRequestWrapper->hasArg("plain"))
+  {
+    IOTWEBCONF_DEBUG_LINE(F("Configuration JSON requested."));
+    this->sendRendered(
+      webRequestWrapper, "application/json",
+      [&](WebRequestWrapper* target)
+      {
+        JsonWriter jsonWriter(target);
+        this->renderValuesJson(&jsonWriter);
+        jsonWriter.flush();
+      });
+    return;
+  }
+
+  this->postConfigJson(webRequestWrapper, false);
+}
+
+void IotWebConf::renderValuesJson(JsonWriter* jsonWriter)
+{
+  jsonWriter->beginObject();
+  this->_systemParameters.renderJson(jsonWriter);
+  this->_customParameterGroups.renderJson(jsonWriter);
+  jsonWriter->endObject();
+}
+
+void IotWebConf::handleEvents(WebRequestWrapper* webRequestWrapper)
+{
+  if (!this->authenticate(webRequestWrapper))
+  {
+    return;
+  }
+
+  IOTWEBCONF_DEBUG_LINE(F("Event stream requested."));
+  WebStream* viewer = this->_eventSource.open(webRequestWrapper);
+  if (viewer != NULL)
+  {
+    // -- Viewer starts with all values, only the changes are sent later.
+    JsonWriter jsonWriter;
+    this->renderValuesJson(&jsonWriter);
+    this->_eventSource.send(viewer, "config", jsonWriter.getContent().c_str());
+  }
+}
+
+void IotWebConf::handleStatusEvents(WebRequestWrapper* webRequestWrapper)
+{
+  IOTWEBCONF_DEBUG_LINE(F("Status event stream requested."));
+  // -- No snapshot is sent, the page shows the status rendered with it.
+  this->_statusEventSource.open(webRequestWrapper);
+}
+
+void IotWebConf::publishStatus(const char* key, const char* value)
+{
+  if (this->_eventSource.hasViewers() || this->_statusEventSource.hasViewers())
+  {
+    JsonWriter jsonWriter;
+    jsonWriter.beginObject();
+    jsonWriter.writeString(key, value);
+    jsonWriter.endObject();
+    this->sendStatus(jsonWriter.getContent().c_str());
+  }
+}
+
+void IotWebConf::publishStatus(const char* key, long value)
+{
+  if (this->_eventSource.hasViewers() || this->_statusEventSource.hasViewers())
+  {
+    char number[21];
+    snprintf(number, sizeof(number), "%ld", value);
+    JsonWriter jsonWriter;
+    jsonWriter.beginObject();
+    jsonWriter.writeNumber(key, number);
+    jsonWriter.endObject();
+    this->sendStatus(jsonWriter.getContent().c_str());
+  }
+}
+
+void IotWebConf::sendStatus(const char* data)
+{
+  this->_eventSource.send("status", data);
+  this->_statusEventSource.send("status", data);
+}
+
+void IotWebConf::handleConfigPatch(WebRequestWrapper* webRequestWrapper)
+{
+  if (!this->authenticate(webRequestWrapper))
+  {
+    return;
+  }
+
+  IOTWEBCONF_DEBUG_LINE(F("Partial configuration update."));
+  if (webRequestWrapper->hasArg("plain"))
+  {
+    this->postConfigJson(webRequestWrapper, true);
+  }
+  else
+  {
+    IndexedWebRequestWrapper indexedWebRequestWrapper(webRequestWrapper);
+    indexedWebRequestWrapper.setPartial(true);
+    this->postConfig(webRequestWrapper, &indexedWebRequestWrapper);
+  }
+}
+
+void IotWebConf::postConfigJson(
+  WebRequestWrapper* webRequestWrapper, bool partial)
+{
+  JsonRequestWrapper jsonRequestWrapper(
+      webRequestWrapper, webRequestWrapper->arg("plain"), partial);
+  if (!jsonRequestWrapper.isValid())
+  {
+    IOTWEBCONF_DEBUG_LINE(F("Malformed configuration JSON."));
+    JsonWriter jsonWriter;
+    jsonWriter.beginObject();
+    jsonWriter.writeBool("ok", false);
+    jsonWriter.writeString("error", "Malformed JSON.");
+    jsonWriter.endObject();
+    this->sendJson(webRequestWrapper, 400, jsonWriter.getContent());
+    return;
+  }
+
+  this->postConfig(webRequestWrapper, &jsonRequestWrapper);
+}
+
+void IotWebConf::postConfig(
+  WebRequestWrapper* webRequestWrapper, WebRequestWrapper* values)
+{
+  if (!this->validateForm(values))
+  {
+    this->sendJsonErrors(webRequestWrapper);
+    return;
+  }
+
+  // -- Save config
+  IOTWEBCONF_DEBUG_LINE(F("Updating configuration"));
+  this->applyConfig(values);
+  this->sendJson(webRequestWrapper, 200, "{\"ok\":true}");
+}
+
+void IotWebConf::serveClientRenderedConfig(WebRequestWrapper* webRequestWrapper)
+{
+  if (webRequestWrapper->hasArg("plain"))
+  {
+    // -- Values posted by the page.
+    this->serveConfigJson(webRequestWrapper);
+  }
+  else if (webRequestWrapper->hasArg("schema"))
+  {
+    IOTWEBCONF_DEBUG_LINE(F("Configuration schema requested."));
+    this->sendRendered(
+      webRequestWrapper, "application/json",
+      [&](WebRequestWrapper* target)
+      {
+        JsonWriter jsonWriter(target);
+        jsonWriter.beginObject();
+        jsonWriter.writeString("cv", this->_configVersion);
+        jsonWriter.beginArray("i");
+        this->_systemParameters.renderJsonSchema(&jsonWriter);
+        this->_customParameterGroups.renderJsonSchema(&jsonWriter);
+        jsonWriter.endArray();
+        jsonWriter.endObject();
+        jsonWriter.flush();
+      });
+  }
+  else
+  {
+    // -- The page itself is static, so it can be cached by the browser.
+    IOTWEBCONF_DEBUG_LINE(F("Configuration page requested."));
+    webRequestWrapper->sendHeader("Cache-Control", "max-age=3600");
+    webRequestWrapper->sendHeader("Content-Encoding", "gzip");
+    webRequestWrapper->send_P(
+        200, PSTR("text/html; charset=UTF-8"), (PGM_P)IOTWEBCONF_SPA_GZ,
+        IOTWEBCONF_SPA_GZ_LENGTH);
+  }
+}
+
+void IotWebConf::sendJson(
+  WebRequestWrapper* webRequestWrapper, int code, const String& content)
+{
+  webRequestWrapper->sendHeader(
+      "Cache-Control", "no-cache, no-store, must-revalidate");
+  webRequestWrapper->setContentLength(content.length());
+  webRequestWrapper->send(code, "application/json", content);
+}
+
+void IotWebConf::sendJsonErrors(WebRequestWrapper* webRequestWrapper)
+{
+  JsonWriter jsonWriter;
+  jsonWriter.beginObject();
+  jsonWriter.writeBool("ok", false);
+  jsonWriter.beginObject("errors");
+  this->_systemParameters.renderJsonError(&jsonWriter);
+  this->_customParameterGroups.renderJsonError(&jsonWriter);
+  jsonWriter.endObject();
+  jsonWriter.endObject();
+  // -- Messages should not appear later on the HTML config page.
+  this->_systemParameters.clearErrorMessage();
+  this->_customParameterGroups.clearErrorMessage();
+  this->sendJson(webRequestWrapper, 400, jsonWriter.getContent());
+}
+
 bool IotWebConf::validateForm(WebRequestWrapper* webRequestWrapper)
 {
   // -- Clean previous error messages.
@@ -333,19 +791,14 @@ bool IotWebConf::validateForm(WebRequestWrapper* webRequestWrapper)
     valid = this->_formValidator(webRequestWrapper);
   }
 
-  // -- Internal validation.
-  int l = webRequestWrapper->arg(this->_thingNameParameter.getId()).length();
-  if (3 > l)
+  // -- Internal validation of all items (including the thing name and AP
+  //    password constraints), nothing is updated before all passed.
+  if (!this->_systemParameters.validate(webRequestWrapper))
   {
-    this->_thingNameParameter.errorMessage =
-        "Give a name with at least 3 characters.";
     valid = false;
   }
-  l = webRequestWrapper->arg(this->_apPasswordParameter.getId()).length();
-  if ((0 < l) && (l < 8))
+  if (!this->_customParameterGroups.validate(webRequestWrapper))
   {
-    this->_apPasswordParameter.errorMessage =
-        "Password length must be at least 8 characters.";
     valid = false;
   }
 
@@ -357,6 +810,37 @@ bool IotWebConf::validateForm(WebRequestWrapper* webRequestWrapper)
   return valid;
 }
 
+void IotWebConf::applyConfig(WebRequestWrapper* webRequestWrapper)
+{
+  this->_systemParameters.update(webRequestWrapper);
+  this->_customParameterGroups.update(webRequestWrapper);
+
+  this->saveConfig();
+
+  // -- Viewers of the event stream receive only the values changed by
+  //    the update.
+  if (this->_eventSource.hasViewers())
+  {
+    JsonWriter jsonWriter;
+    jsonWriter.beginObject();
+    this->_systemParameters.renderChangedJson(&jsonWriter);
+    this->_customParameterGroups.renderChangedJson(&jsonWriter);
+    jsonWriter.endObject();
+    if (jsonWriter.getContent().length() > 2)
+    {
+      this->_eventSource.send("config", jsonWriter.getContent().c_str());
+    }
+  }
+}
+
+/**
+ * Paths requested by the operating systems to detect a captive portal.
+ * These are redirected to the portal even when sent to our own address.
+ */
+static const char* const captivePortalProbePaths[] = {
+  "/generate_204", "/gen_204", "/hotspot-detect.html", "/connecttest.txt",
+  "/ncsi.txt", "/canonical.html", "/success.txt", "/redirect", NULL };
+
 void IotWebConf::handleNotFound(WebRequestWrapper* webRequestWrapper)
 {
   if (this->handleCaptivePortal(webRequestWrapper))
@@ -364,6 +848,26 @@ void IotWebConf::handleNotFound(WebRequestWrapper* webRequestWrapper)
     // If captive portal redirect instead of displaying the error page.
     return;
   }
+  // -- Longer than any of the paths compared below, a longer URI is cut, and
+  //    does not match.
+  char uri[24];
+  bool uriCut = webRequestWrapper->readUri(uri, sizeof(uri)) >= sizeof(uri);
+  if (!uriCut && (strcmp(uri, "/favicon.ico") == 0))
+  {
+    // -- Requested by every browser, answered without building a page.
+    webRequestWrapper->setContentLength(0);
+    webRequestWrapper->send(404, "image/x-icon", "");
+    return;
+  }
+  for (const char* const* probePath = captivePortalProbePaths;
+    !uriCut && (*probePath != NULL); probePath++)
+  {
+    if (strcmp(uri, *probePath) == 0)
+    {
+      this->redirectToPortal(webRequestWrapper);
+      return;
+    }
+  }
 #ifdef IOTWEBCONF_DEBUG_TO_SERIAL
   Serial.print(F("Requested a non-existing page '"));
   Serial.print(webRequestWrapper->uri());
@@ -378,7 +882,7 @@ void IotWebConf::handleNotFound(WebRequestWrapper* webRequestWrapper)
       "Cache-Control", "no-cache, no-store, must-revalidate");
   webRequestWrapper->sendHeader("Pragma", "no-cache");
   webRequestWrapper->sendHeader("Expires", "-1");
-  webRequestWrapper->sendHeader("Content-Length", String(message.length()));
+  webRequestWrapper->setContentLength(message.length());
   webRequestWrapper->send(404, "text/plain", message);
 }
 
@@ -389,10 +893,15 @@ void IotWebConf::handleNotFound(WebRequestWrapper* webRequestWrapper)
  */
 bool IotWebConf::handleCaptivePortal(WebRequestWrapper* webRequestWrapper)
 {
-  String host = webRequestWrapper->hostHeader();
-  String thingName = String(this->_thingName);
-  thingName.toLowerCase();
-  if (!isIp(host) && !host.startsWith(thingName))
+  // -- Only the start of the host is compared, that fits the thing name (or
+  //    an address with a port). A longer host is cut, and is not an address.
+  char host[IOTWEBCONF_WORD_LEN];
+  bool hostCut =
+    webRequestWrapper->readHostHeader(host, sizeof(host)) >= sizeof(host);
+  // -- Thing name is compared case insensitive, instead of creating a lower
+  //    case copy for every request.
+  if ((hostCut || !isIp(host))
+    && (strncasecmp(host, this->_thingName, strlen(this->_thingName)) != 0))
   {
 #ifdef IOTWEBCONF_DEBUG_TO_SERIAL
     Serial.print("Request for ");
@@ -400,22 +909,41 @@ bool IotWebConf::handleCaptivePortal(WebRequestWrapper* webRequestWrapper)
     Serial.print(" redirected to ");
     Serial.println(webRequestWrapper->localIP());
 #endif
-    webRequestWrapper->sendHeader(
-      "Location", String("http://") + toStringIp(webRequestWrapper->localIP()), true);
-    webRequestWrapper->send(302, "text/plain", ""); // Empty content inhibits Content-length header so we have to close the socket ourselves.
-    webRequestWrapper->stop(); // Stop is needed because we sent no content length
+    this->redirectToPortal(webRequestWrapper);
     return true;
   }
   return false;
 }
 
+void IotWebConf::redirectToPortal(WebRequestWrapper* webRequestWrapper)
+{
+  // -- Every device joining the AP fires several connectivity probes, so
+  //    the location is only built again when the address was changed.
+  uint32_t localIp = webRequestWrapper->localIP();
+  if ((this->_captivePortalLocation.length() == 0)
+    || (localIp != this->_captivePortalIp))
+  {
+    this->_captivePortalIp = localIp;
+    this->_captivePortalLocation =
+      String("http://") + toStringIp(webRequestWrapper->localIP());
+  }
+  webRequestWrapper->sendHeader("Location", this->_captivePortalLocation, true);
+  // -- An explicit zero length lets the client reuse the connection for
+  //    the portal page.
+  webRequestWrapper->setContentLength(0);
+  webRequestWrapper->send(302, "text/plain", "");
+}
+
 /** Is this an IP? */
 bool IotWebConf::isIp(String str)
 {
-  for (size_t i = 0; i < str.length(); i++)
+  return isIp(str.c_str());
+}
+bool IotWebConf::isIp(const char* str)
+{
+  for (const char* c = str; *c != '\0'; c++)
   {
-    int c = str.charAt(i);
-    if (c != '.' && (c < '0' || c > '9'))
+    if (*c != '.' && (*c < '0' || *c > '9'))
     {
       return false;
     }
@@ -440,20 +968,78 @@ String IotWebConf::toStringIp(IPAddress ip)
 void IotWebConf::delay(unsigned long m)
 {
   unsigned long delayStart = millis();
+  unsigned long idleSleep = 0;
   while (m > millis() - delayStart)
   {
     this->doLoop();
-    // -- Note: 1ms might not be enough to perform a full yield. So
-    // 'yield' in 'doLoop' is eventually a good idea.
-    delayMicroseconds(1000);
+    if (this->_loopBusy)
+    {
+      // -- There might be more work waiting, check again right away.
+      idleSleep = 0;
+      continue;
+    }
+    // -- Nothing to do: sleep (the system can run its tasks or save power
+    //    meanwhile), and sleep longer while nothing happens.
+    idleSleep = idleSleep == 0 ? 1 : idleSleep * 2;
+    if (idleSleep > IOTWEBCONF_IDLE_SLEEP_MAX_MILLIS)
+    {
+      idleSleep = IOTWEBCONF_IDLE_SLEEP_MAX_MILLIS;
+    }
+    // -- doLoop() might have taken the rest of the time.
+    unsigned long elapsed = millis() - delayStart;
+    if (elapsed >= m)
+    {
+      break;
+    }
+    unsigned long remaining = m - elapsed;
+    ::delay(idleSleep < remaining ? idleSleep : remaining);
   }
 }
 
 void IotWebConf::doLoop()
 {
   yield(); // -- Yield should not be necessary, but cannot hurt either.
-  this->_dnsServer->processNextRequest();
-  this->_webServerWrapper->handleClient();
+  bool portalIdle = this->isPortalIdle(millis());
+  this->_dnsLoopTask.suspended = portalIdle;
+  this->_httpLoopTask.suspended = portalIdle;
+  this->_loopBusy = this->_loopScheduler.runPass(this->_loopBudgetMicros);
+  if (!portalIdle
+    && (this->_dnsLoopTask.hasWorked() || this->_httpLoopTask.hasWorked()))
+  {
+    // -- A request was served (e.g. by a heartbeat poll).
+    this->_portalActiveMillis = millis();
+  }
+}
+
+/**
+ * Portal is idle, when no station is connected to the AP, no request came
+ * in lately, and nobody watches an event stream. Stations are only checked
+ * on heartbeats, when the DNS and HTTP tasks are also polled once.
+ */
+bool IotWebConf::isPortalIdle(unsigned long now)
+{
+  if ((IOTWEBCONF_PORTAL_HEARTBEAT_MILLIS == 0)
+    || (now - this->_portalActiveMillis < IOTWEBCONF_PORTAL_ACTIVE_HOLD_MILLIS))
+  {
+    return false;
+  }
+  if (this->_eventSource.hasViewers() || this->_statusEventSource.hasViewers())
+  {
+    // -- Events are written (and kept alive) by the HTTP task, so it must
+    //    not wait for heartbeats.
+    this->_portalActiveMillis = now;
+    return false;
+  }
+  if (now - this->_portalHeartbeatMillis < IOTWEBCONF_PORTAL_HEARTBEAT_MILLIS)
+  {
+    return true;
+  }
+  this->_portalHeartbeatMillis = now;
+  if (WiFi.softAPgetStationNum() > 0)
+  {
+    this->_portalActiveMillis = now;
+  }
+  return false;
 }
 
 } // end namespace
\ No newline at end of file
@@ -25,6 +25,10 @@
 #include <WebServer.h>
 #endif
 #include <DNSServer.h> // -- For captive portal
+#include <IotWebConfDnsServer.h>
+#include <IotWebConfEventSource.h>
+#include <IotWebConfLoopTask.h>
+#include <IotWebConfSession.h>
 
 #ifdef ESP8266
 #ifndef WebServer
@@ -67,6 +71,32 @@ const char IOTWEBCONF_HTML_SAVED[] PROGMEM =
 const char IOTWEBCONF_HTML_END[] PROGMEM = "</div></body></html>";
 const char IOTWEBCONF_HTML_UPDATE[] PROGMEM =
     "<div style='padding-top:25px;'><a href='{u}'>Firmware update</a></div>\n";
+const char IOTWEBCONF_HTML_LAZY_GROUP_SCRIPT_INNER[] PROGMEM =
+    "function lg(id) { var d=document.getElementById(id + 'lz'); "
+    "if (!d || d.dataset.l) { return; } d.dataset.l=1; var r=new XMLHttpRequest(); "
+    "r.onload=function() { if (r.status==200) { d.outerHTML=r.responseText; } "
+    "else { delete d.dataset.l; } }; r.onerror=function() { delete d.dataset.l; }; "
+    "r.open('GET', location.pathname + '?iotGroup=' + encodeURIComponent(id)); "
+    "r.send(); };";
+const char IOTWEBCONF_HTML_AJAX_SAVE_SCRIPT_INNER[] PROGMEM =
+    "function as(f) { var r=new XMLHttpRequest(); "
+    "r.onload=function() { var j; try { j=JSON.parse(r.responseText); } "
+    "catch (x) { f.submit(); return; } var e=f.querySelectorAll('.em'); "
+    "for (var i=0; i<e.length; i++) { e[i].textContent=''; "
+    "e[i].parentNode.classList.remove('de'); } var m=j.errors || {}; "
+    "for (var k in m) { var d=document.getElementById(k); if (d) { "
+    "d.parentNode.classList.add('de'); "
+    "d.parentNode.querySelector('.em').textContent=m[k]; } } "
+    "var s=document.getElementById('iotSt'); if (!s) { "
+    "s=document.createElement('div'); s.id='iotSt'; s.className='c'; "
+    "f.appendChild(s); } s.textContent=j.ok ? 'Configuration saved.' : "
+    "'Please correct the marked fields.'; }; "
+    "r.onerror=function() { f.submit(); }; "
+    "var d=new URLSearchParams(new FormData(f)); d.append('iotAjax', '1'); "
+    "r.open('POST', location.pathname); r.setRequestHeader('Content-Type', "
+    "'application/x-www-form-urlencoded'); r.send(d.toString()); return false; }; "
+    "document.addEventListener('DOMContentLoaded', function() { "
+    "var f=document.forms[0]; if (f) { f.onsubmit=function() { return as(f); }; } });";
 const char IOTWEBCONF_HTML_CONFIG_VER[] PROGMEM =
     "<div style='font-size: .6em;'>Firmware config version '{v}'</div>\n";
 
@@ -98,6 +128,14 @@ public:
     return "<script>" + getScriptInner() + "</script>";
   }
   virtual String getHeadExtension() { return ""; }
+  virtual String getLazyGroupScript()
+  {
+    return "<script>" + String(FPSTR(IOTWEBCONF_HTML_LAZY_GROUP_SCRIPT_INNER)) + "</script>";
+  }
+  virtual String getAjaxSaveScript()
+  {
+    return "<script>" + String(FPSTR(IOTWEBCONF_HTML_AJAX_SAVE_SCRIPT_INNER)) + "</script>";
+  }
   virtual String getHeadEnd()
   {
     return String(FPSTR(IOTWEBCONF_HTML_HEAD_END)) + getBodyInner();
@@ -118,6 +156,34 @@ protected:
   virtual String getBodyInner() { return FPSTR(IOTWEBCONF_HTML_BODY_INNER); }
 };
 
+/**
+ * Stream over a client of the WebServer. The WebServer lets the connection
+ * go after the handler, but it is kept open by holding the client.
+ */
+class StandardWebStream : public WebStream
+{
+public:
+  StandardWebStream(WiFiClient client) : _client(client) { };
+  ~StandardWebStream() { this->close(); };
+
+  bool connected() override { return this->_client.connected(); };
+  bool write(const char* data, size_t length) override
+  {
+#ifdef ESP8266
+    // -- Write would block until the client has read enough.
+    if ((size_t)this->_client.availableForWrite() < length)
+    {
+      return false;
+    }
+#endif
+    return this->_client.write((const uint8_t*)data, length) == length;
+  };
+  void close() override { this->_client.stop(); };
+
+private:
+  WiFiClient _client;
+};
+
 class StandardWebRequestWrapper : public WebRequestWrapper
 {
 public:
@@ -129,19 +195,44 @@ public:
   };
   IPAddress localIP() override { return this->_server->client().localIP(); };
   const String uri() const { return this->_server->uri(); };
+  size_t readHostHeader(char* buffer, size_t size) override
+  {
+    // -- No copy is made, where the WebServer returns a reference.
+    const String& host = this->_server->hostHeader();
+    return copyValue(host, buffer, size);
+  };
+  size_t readUri(char* buffer, size_t size) override
+  {
+    const String& uri = this->_server->uri();
+    return copyValue(uri, buffer, size);
+  };
   bool authenticate(const char* username, const char* password) override
   {
     return this->_server->authenticate(username, password);
   };
   void requestAuthentication() override
   {
+#ifdef IOTWEBCONF_AUTH_DIGEST
+    this->_server->requestAuthentication(DIGEST_AUTH);
+#else
     this->_server->requestAuthentication();
+#endif
   };
   bool hasArg(const String& name) override
   {
     return this->_server->hasArg(name);
   };
   String arg(const String name) override { return this->_server->arg(name); };
+  int args() override { return this->_server->args(); };
+  String argName(int i) override { return this->_server->argName(i); };
+  String argValue(int i) override { return this->_server->arg(i); };
+  using WebRequestWrapper::hasArg;
+  using WebRequestWrapper::arg;
+  using WebRequestWrapper::readArg;
+  String header(const String& name) override
+  {
+    return this->_server->header(name);
+  };
   void sendHeader(
       const String& name, const String& value, bool first = false) override
   {
@@ -157,11 +248,46 @@ public:
   {
     this->_server->send(code, content_type, content);
   };
+  void send(
+      int code, const char* content_type, const char* content,
+      size_t length) override
+  {
+    if (content_type == NULL)
+    {
+      WebRequestWrapper::send(code, content_type, content, length);
+      return;
+    }
+    // -- Reading program memory works on RAM as well.
+    this->_server->send_P(code, content_type, content, length);
+  };
+  void send_P(
+      int code, PGM_P content_type, PGM_P content, size_t length) override
+  {
+    this->_server->send_P(code, content_type, content, length);
+  };
   void sendContent(const String& content) override
   {
     this->_server->sendContent(content);
   };
+  void sendContent_P(PGM_P content, size_t size) override
+  {
+    this->_server->sendContent_P(content, size);
+  };
   void stop() override { this->_server->client().stop(); };
+  WebStream* openStream(const char* content_type) override
+  {
+    // -- Head is sent as raw content, so the WebServer neither ends the
+    //    content, nor closes the connection after the handler.
+    String head = F("HTTP/1.1 200 OK\r\nCache-Control: no-cache\r\n"
+      "Connection: keep-alive\r\nContent-Type: ");
+    head += content_type;
+    head += F("\r\n\r\n");
+    this->_server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    this->_server->sendContent(head);
+    return new StandardWebStream(this->_server->client());
+  };
+  using WebRequestWrapper::sendHeader;
+  using WebRequestWrapper::sendContent;
 
 private:
   WebServer* _server;
@@ -173,16 +299,38 @@ class StandardWebServerWrapper : public WebServerWrapper
 public:
   StandardWebServerWrapper(WebServer* server) { this->_server = server; };
 
-  void handleClient() override { this->_server->handleClient(); };
+  bool handleClient() override
+  {
+    this->_served = false;
+    this->_server->handleClient();
+    return this->_served;
+  };
   void begin() override { this->_server->begin(); };
 
 private:
   StandardWebServerWrapper(){};
   WebServer* _server;
+  // -- WebServer does not tell, whether it served a request. Requests
+  //    reaching the handlers of IotWebConf are noticed (see
+  //    IotWebConf::currentRequest()).
+  bool _served = false;
   friend IotWebConf;
 };
 
 
+class StandardDnsServerWrapper : public DnsServerWrapper
+{
+public:
+  StandardDnsServerWrapper(DNSServer* dnsServer) { this->_dnsServer = dnsServer; };
+
+  void processNextRequest() override { this->_dnsServer->processNextRequest(); };
+
+private:
+  StandardDnsServerWrapper(){};
+  DNSServer* _dnsServer;
+  friend IotWebConf;
+};
+
 /**
  * Main class of the module.
  */
@@ -193,8 +341,8 @@ public:
    * Create a new configuration handler.
    *   @thingName - Initial value for the thing name. Used in many places like
    * AP name, can be changed by the user.
-   *   @dnsServer - A created DNSServer, that can be configured for captive
-   * portal.
+   *   @dnsServer - A created DNSServer (or CaptiveDnsServer), that can be
+   * configured for captive portal.
    *   @server - A created web server. Will be started upon connection success.
    *   @initialApPassword - Initial value for AP mode. Can be changed by the
    * user.
@@ -205,6 +353,27 @@ public:
   IotWebConf(
       const char* thingName, DNSServer* dnsServer, WebServer* server,
       const char* initialApPassword, const char* configVersion = "init")
+      : IotWebConf(
+            thingName, &this->_standardDnsServerWrapper,
+            &this->_standardWebServerWrapper, initialApPassword, configVersion)
+  {
+    this->_standardDnsServerWrapper._dnsServer = dnsServer;
+    this->_standardWebServerWrapper._server = server;
+  }
+
+  IotWebConf(
+      const char* thingName, DNSServer* dnsServer, WebServerWrapper* server,
+      const char* initialApPassword, const char* configVersion = "init")
+      : IotWebConf(
+            thingName, &this->_standardDnsServerWrapper, server,
+            initialApPassword, configVersion)
+  {
+    this->_standardDnsServerWrapper._dnsServer = dnsServer;
+  }
+
+  IotWebConf(
+      const char* thingName, DnsServerWrapper* dnsServer, WebServer* server,
+      const char* initialApPassword, const char* configVersion = "init")
       : IotWebConf(
             thingName, dnsServer, &this->_standardWebServerWrapper,
             initialApPassword, configVersion)
@@ -213,7 +382,7 @@ public:
   }
 
   IotWebConf(
-      const char* thingName, DNSServer* dnsServer, WebServerWrapper* server,
+      const char* thingName, DnsServerWrapper* dnsServer, WebServerWrapper* server,
       const char* initialApPassword, const char* configVersion = "init");
 
 
@@ -233,6 +402,44 @@ public:
    */
   void doLoop();
 
+  /**
+   * Add a task to be run from doLoop(), next to the DNS and HTTP request
+   * handling. The task function receives the time it may spend (limited by
+   * the budget of the task and by the time left in the loop pass).
+   */
+  void addLoopTask(LoopTask* task) { this->_loopScheduler.addTask(task); }
+
+  /**
+   * Time a doLoop() call may spend with running the tasks (microseconds).
+   * As tasks are not interrupted, a call might be longer by the overrun
+   * of the last task. The default is IOTWEBCONF_LOOP_BUDGET_MICROS.
+   */
+  void setLoopBudget(unsigned long loopBudgetMicros)
+  {
+    this->_loopBudgetMicros = loopBudgetMicros;
+  }
+
+  /**
+   * The built in tasks. Use these to tune their budget, or to see how much
+   * time they consume.
+   */
+  LoopTask* getDnsLoopTask() { return &this->_dnsLoopTask; }
+  LoopTask* getHttpLoopTask() { return &this->_httpLoopTask; }
+
+  /**
+   * Print the time consumed by the loop tasks.
+   */
+  void debugLoopTasksTo(Stream* out) { this->_loopScheduler.debugTo(out); }
+
+  /**
+   * While nobody is using the portal (no station is connected to the AP,
+   * and no request came in lately), the DNS and HTTP tasks are only run
+   * once in every IOTWEBCONF_PORTAL_HEARTBEAT_MILLIS, leaving more time to
+   * your loop(). Call this, when you know about a client coming (e.g. from
+   * a WiFi event handler), to return to full rate polling immediately.
+   */
+  void wakePortal() { this->_portalActiveMillis = millis(); }
+
   /**
    * Each WebServer URL handler method should start with calling this method.
    * If this method return true, the request was already served by it.
@@ -240,8 +447,7 @@ public:
   bool handleCaptivePortal(WebRequestWrapper* webRequestWrapper);
   bool handleCaptivePortal()
   {
-    StandardWebRequestWrapper webRequestWrapper =
-        StandardWebRequestWrapper(this->_standardWebServerWrapper._server);
+    StandardWebRequestWrapper webRequestWrapper = this->currentRequest();
     return handleCaptivePortal(&webRequestWrapper);
   }
 
@@ -251,11 +457,91 @@ public:
   void handleConfig(WebRequestWrapper* webRequestWrapper);
   void handleConfig()
   {
-    StandardWebRequestWrapper webRequestWrapper =
-        StandardWebRequestWrapper(this->_standardWebServerWrapper._server);
+    StandardWebRequestWrapper webRequestWrapper = this->currentRequest();
     handleConfig(&webRequestWrapper);
   }
 
+  /**
+   * Config JSON web request handler. Call this method to handle config
+   * requests of scripts and tools, e.g. registered for "/config.json".
+   * Requests without body are answered with a flat JSON object holding the
+   * actual value of every parameter on the config portal keyed by the
+   * parameter ID (passwords are left out). When a JSON object is posted
+   * (with "Content-Type: application/json"), values are validated and
+   * saved just like values of a form post. The answer is {"ok":true}, or
+   * the validation error messages keyed by the parameter IDs.
+   */
+  void handleConfigJson(WebRequestWrapper* webRequestWrapper);
+  void handleConfigJson()
+  {
+    StandardWebRequestWrapper webRequestWrapper = this->currentRequest();
+    handleConfigJson(&webRequestWrapper);
+  }
+
+  /**
+   * Partial config update web request handler, e.g. registered for
+   * "/config.json" with method PATCH. Only the parameters present in the
+   * request (a JSON object, or form arguments) are validated and changed,
+   * all other items are left untouched. (So a checkbox must be posted
+   * explicitly as false or empty to uncheck it.) The answer is the same as
+   * for handleConfigJson(). No "iotSave" argument is required.
+   */
+  void handleConfigPatch(WebRequestWrapper* webRequestWrapper);
+  void handleConfigPatch()
+  {
+    StandardWebRequestWrapper webRequestWrapper = this->currentRequest();
+    handleConfigPatch(&webRequestWrapper);
+  }
+
+  /**
+   * Event stream web request handler, e.g. registered for "/events", to be
+   * read by an EventSource of the browser. The client receives a "config"
+   * event right away with the actual values (the same JSON object as of
+   * handleConfigJson()), then a "config" event with only the values changed
+   * whenever the configuration is saved, and the "status" events published
+   * (see publishStatus()). At most IOTWEBCONF_EVENT_MAX_VIEWERS clients are
+   * served, every one keeping its connection open. Requires authentication,
+   * as the values are sent.
+   */
+  void handleEvents(WebRequestWrapper* webRequestWrapper);
+  void handleEvents()
+  {
+    StandardWebRequestWrapper webRequestWrapper = this->currentRequest();
+    handleEvents(&webRequestWrapper);
+  }
+
+  /**
+   * Event stream web request handler for public pages (e.g. registered for
+   * "/status-events"). The client receives only the "status" events
+   * published (see publishStatus()), thus no authentication is required.
+   * Viewers are kept apart from the ones of handleEvents(), with
+   * IOTWEBCONF_EVENT_MAX_VIEWERS places of their own.
+   */
+  void handleStatusEvents(WebRequestWrapper* webRequestWrapper);
+  void handleStatusEvents()
+  {
+    StandardWebRequestWrapper webRequestWrapper = this->currentRequest();
+    handleStatusEvents(&webRequestWrapper);
+  }
+
+  /**
+   * Push a value to the viewers of both event streams, as a "status" event
+   * with data {"key":"value"} (or {"key":number}). Nothing is done, while
+   * there are no viewers.
+   */
+  void publishStatus(const char* key, const char* value);
+  void publishStatus(const char* key, long value);
+
+  /**
+   * The event stream of handleEvents(), e.g. for sending events of your own.
+   */
+  EventSource* getEventSource() { return &this->_eventSource; }
+  /**
+   * The event stream of handleStatusEvents(). Only data that is fine to
+   * be seen without authentication should be sent here.
+   */
+  EventSource* getStatusEventSource() { return &this->_statusEventSource; }
+
   /**
    * URL-not-found web request handler. Used for handling captive portal
    * request.
@@ -263,8 +549,7 @@ public:
   void handleNotFound(WebRequestWrapper* webRequestWrapper);
   void handleNotFound()
   {
-    StandardWebRequestWrapper webRequestWrapper =
-        StandardWebRequestWrapper(this->_standardWebServerWrapper._server);
+    StandardWebRequestWrapper webRequestWrapper = this->currentRequest();
     handleNotFound(&webRequestWrapper);
   }
 
@@ -324,6 +609,9 @@ public:
 
   /**
    * Use this delay, to prevent blocking IotWebConf.
+   * While there is nothing to do, the CPU is given to the system in sleeps
+   * getting longer (up to IOTWEBCONF_IDLE_SLEEP_MAX_MILLIS), instead of
+   * spinning.
    */
   void delay(unsigned long millis);
 
@@ -356,6 +644,62 @@ public:
    */
   bool loadConfig();
 
+  /**
+   * With client rendered portal enabled, handleConfig() will not render the
+   * HTML form. Instead a static, precompressed page is sent, that renders the
+   * form in the browser from a compact JSON schema (requested with "?schema"
+   * on the same URL), and posts the values back as JSON (see
+   * handleConfigJson()). This saves a lot of CPU and memory on the device,
+   * but note that HtmlFormatProvider is not used in this mode, and custom
+   * parameter types must implement renderJsonSchema() to appear.
+   */
+  void setClientRenderedPortal(bool clientRendered)
+  {
+    this->_clientRenderedPortal = clientRendered;
+  }
+
+  /**
+   * With lazy group loading enabled, the config page contains only the frame
+   * of each (labeled) custom parameter group, and the fields of a group are
+   * fetched by the browser when the user opens it (with "?iotGroup=<id>" on
+   * the same URL). The size of the page thus depends only on the number of
+   * groups, and not on the number of parameters.
+   * Note, that the fields of a group not opened by the user are not posted,
+   * so a custom form validator must not expect them to be present. (The
+   * "<id>lazy" argument is posted for those groups instead.)
+   */
+  void setLazyGroupLoading(bool lazyGroupLoading)
+  {
+    this->_lazyGroupLoading = lazyGroupLoading;
+  }
+
+  /**
+   * With AJAX save enabled, the config form is posted by a script of the
+   * page (with an additional "iotAjax" argument), and the device answers
+   * with a small JSON document instead of a whole new page: either
+   * {"ok":true}, or {"ok":false,"errors":{"<id>":"<message>",...}}. The
+   * page stays as it is, only the rejected fields are marked. When the
+   * script fails, the form is posted the traditional way.
+   */
+  void setAjaxSave(bool ajaxSave)
+  {
+    this->_ajaxSave = ajaxSave;
+  }
+
+  /**
+   * With session authentication enabled, a browser passing the
+   * authentication of the config portal receives a random session token in
+   * a cookie. The following requests presenting a valid token are accepted
+   * without checking the credentials again (which is costly with Digest
+   * authentication). A session expires when not used for
+   * IOTWEBCONF_SESSION_TIMEOUT_MILLIS, and all sessions are dropped when the
+   * configuration is saved.
+   * The request wrapper must provide the "Cookie" header. For the standard
+   * WebServer, this method asks the server to collect it, replacing any
+   * headers collected before.
+   */
+  void setSessionAuth(bool sessionAuth);
+
   /**
    * With this method you can override the default HTML format provider to
    * provide custom HTML segments.
@@ -369,12 +713,15 @@ public:
     return this->htmlFormatProvider;
   }
   bool isIp(String str);
+  bool isIp(const char* str);
   String toStringIp(IPAddress ip);
 
 private:
   const char* _initialApPassword = NULL;
   const char* _configVersion;
-  DNSServer* _dnsServer;
+  DnsServerWrapper* _dnsServer;
+  StandardDnsServerWrapper _standardDnsServerWrapper =
+      StandardDnsServerWrapper();
   WebServerWrapper* _webServerWrapper;
   StandardWebServerWrapper _standardWebServerWrapper =
       StandardWebServerWrapper();
@@ -399,14 +746,82 @@ private:
   std::function<bool(WebRequestWrapper* webRequestWrapper)> _formValidator = NULL;
   HtmlFormatProvider htmlFormatProviderInstance;
   HtmlFormatProvider* htmlFormatProvider = &htmlFormatProviderInstance;
-
+  bool _clientRenderedPortal = false;
+  bool _lazyGroupLoading = false;
+  bool _ajaxSave = false;
+  bool _sessionAuth = false;
+  SessionCache _sessions;
+  EventSource _eventSource;
+  EventSource _statusEventSource;
+  LoopScheduler _loopScheduler;
+  unsigned long _loopBudgetMicros = IOTWEBCONF_LOOP_BUDGET_MICROS;
+  bool _loopBusy = false;
+  // -- Loop tasks are run between the slices of a page rendered (see
+  //    renderSliced()), except for the dry run calculating its length.
+  bool _renderSlicing = true;
+  bool _renderSliceNeeded = false;
+  unsigned long _portalActiveMillis = 0;
+  unsigned long _portalHeartbeatMillis = 0;
+  LoopTask _dnsLoopTask = LoopTask(
+      "dns",
+      [this](unsigned long budgetMicros)
+      {
+        if (this->_dnsServer->processRequests(budgetMicros) > 0)
+        {
+          this->_dnsLoopTask.reportWork();
+        }
+      },
+      IOTWEBCONF_DNS_TIME_BUDGET_MICROS);
+  LoopTask _httpLoopTask = LoopTask(
+      "http",
+      [this](unsigned long budgetMicros)
+      {
+        if (this->_webServerWrapper->handleClient())
+        {
+          this->_httpLoopTask.reportWork();
+        }
+        this->_eventSource.loop();
+        this->_statusEventSource.loop();
+      },
+      IOTWEBCONF_LOOP_BUDGET_MICROS);
+  uint32_t _captivePortalIp = 0;
+  String _captivePortalLocation;
+
+  // -- Request of the WebServer being served, noting that a request was
+  //    served (see StandardWebServerWrapper::handleClient()).
+  StandardWebRequestWrapper currentRequest()
+  {
+    this->_standardWebServerWrapper._served = true;
+    return StandardWebRequestWrapper(this->_standardWebServerWrapper._server);
+  }
   int initConfig();
   bool testConfigVersion();
   void saveConfigVersion();
   void readEepromValue(int start, byte* valueBuffer, int length);
   void writeEepromValue(int start, byte* valueBuffer, int length);
 
+  bool authenticate(WebRequestWrapper* webRequestWrapper);
   bool validateForm(WebRequestWrapper* webRequestWrapper);
+  void applyConfig(WebRequestWrapper* webRequestWrapper);
+  void serveConfigJson(WebRequestWrapper* webRequestWrapper);
+  void renderValuesJson(JsonWriter* jsonWriter);
+  void sendStatus(const char* data);
+  void postConfigJson(WebRequestWrapper* webRequestWrapper, bool partial);
+  void postConfig(
+      WebRequestWrapper* webRequestWrapper, WebRequestWrapper* values);
+  void renderConfigPage(bool dataArrived, WebRequestWrapper* webRequestWrapper);
+  void renderSliced(
+      HtmlRenderCursor* cursor, WebRequestWrapper* webRequestWrapper);
+  void serveConfigGroup(WebRequestWrapper* webRequestWrapper);
+  void sendRendered(
+      WebRequestWrapper* webRequestWrapper, const char* contentType,
+      std::function<void(WebRequestWrapper* target)> render);
+  void serveClientRenderedConfig(WebRequestWrapper* webRequestWrapper);
+  void sendJson(
+      WebRequestWrapper* webRequestWrapper, int code, const String& content);
+  void sendJsonErrors(WebRequestWrapper* webRequestWrapper);
+  void redirectToPortal(WebRequestWrapper* webRequestWrapper);
+  bool isPortalIdle(unsigned long now);
 };
 
 } // namespace iotwebconf
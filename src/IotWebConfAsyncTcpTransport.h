@@ -0,0 +1,185 @@
+/**
+ * IotWebConfAsyncTcpTransport.h -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfAsyncTcpTransport_h
+#define IotWebConfAsyncTcpTransport_h
+
+// -- This file is not included by IotWebConf.h, include it only when the
+//    ESPAsyncTCP (ESP8266) or AsyncTCP (ESP32) library is available.
+#ifdef ESP8266
+# include <ESPAsyncTCP.h>
+#elif defined(ESP32)
+# include <AsyncTCP.h>
+# include <mutex>
+#endif
+#include <IotWebConfAsyncWebServer.h>
+
+// -- On ESP32 the callbacks of AsyncTCP are called from its own task, on
+//    ESP8266 these never interrupt the loop.
+#ifdef ESP32
+# define IOTWEBCONF_ASYNC_TCP_LOCK() \
+    std::lock_guard<std::mutex> lock(this->_mutex)
+#else
+# define IOTWEBCONF_ASYNC_TCP_LOCK()
+#endif
+
+namespace iotwebconf
+{
+
+class AsyncTcpTransport;
+
+/**
+ * Connection of the AsyncTcpTransport. Events of the TCP stack are recorded
+ * here, until the transport delivers them from poll().
+ */
+class AsyncTcpConnection final : public AsyncConnection
+{
+public:
+  AsyncTcpConnection(AsyncClient* client) { this->_client = client; };
+
+  size_t space() override
+  {
+    return this->_closed ? 0 : this->_client->space();
+  };
+  size_t write(const char* data, size_t length) override
+  {
+    return this->_client->write(data, length);
+  };
+  void close() override
+  {
+    this->_closed = true;
+    this->_client->close();
+  };
+  IPAddress localIP() override { return this->_client->localIP(); };
+
+private:
+  AsyncClient* _client;
+  String _received;
+  bool _connected = false;
+  bool _closed = false;
+  bool _disconnected = false;
+  AsyncTcpConnection* _nextConnection = NULL;
+  friend class AsyncTcpTransport;
+};
+
+/**
+ * AsyncTransport over the ESPAsyncTCP / AsyncTCP libraries:
+ *   AsyncTcpTransport transport;
+ *   AsyncWebServerWrapper server(&transport);
+ *   IotWebConf iotWebConf(thingName, &dnsServer, &server, ...);
+ */
+class AsyncTcpTransport : public AsyncTransport
+{
+public:
+  ~AsyncTcpTransport() { delete this->_server; };
+
+  bool begin(uint16_t port, AsyncConnectionHandler* handler) override
+  {
+    this->_handler = handler;
+    this->_server = new AsyncServer(port);
+    this->_server->onClient(
+      [this](void* arg, AsyncClient* client) { this->added(client); }, NULL);
+    this->_server->begin();
+    return true;
+  };
+
+  void poll() override
+  {
+    {
+      IOTWEBCONF_ASYNC_TCP_LOCK();
+      // -- Connections added by the stack are taken over.
+      AsyncTcpConnection** last = &this->_firstConnection;
+      while (*last != NULL)
+      {
+        last = &(*last)->_nextConnection;
+      }
+      *last = this->_addedConnections;
+      this->_addedConnections = NULL;
+    }
+
+    AsyncTcpConnection** link = &this->_firstConnection;
+    while (*link != NULL)
+    {
+      AsyncTcpConnection* connection = *link;
+      String received;
+      bool disconnected;
+      {
+        IOTWEBCONF_ASYNC_TCP_LOCK();
+        std::swap(received, connection->_received);
+        disconnected = connection->_disconnected;
+      }
+      if (!connection->_connected)
+      {
+        connection->_connected = true;
+        this->_handler->onConnect(connection);
+      }
+      if (!connection->_closed && (received.length() > 0))
+      {
+        this->_handler->onData(
+          connection, received.c_str(), received.length());
+      }
+      if (!disconnected)
+      {
+        link = &connection->_nextConnection;
+        continue;
+      }
+      if (!connection->_closed)
+      {
+        this->_handler->onDisconnect(connection);
+      }
+      // -- Stack does not use the client after its disconnect event.
+      *link = connection->_nextConnection;
+      delete connection->_client;
+      delete connection;
+    }
+  };
+
+private:
+  AsyncServer* _server = NULL;
+  AsyncConnectionHandler* _handler = NULL;
+  AsyncTcpConnection* _firstConnection = NULL;
+  AsyncTcpConnection* _addedConnections = NULL;
+#ifdef ESP32
+  std::mutex _mutex;
+#endif
+
+  void added(AsyncClient* client)
+  {
+    AsyncTcpConnection* connection = new AsyncTcpConnection(client);
+    client->onData(
+      [this, connection](void* arg, AsyncClient* c, void* data, size_t length)
+      {
+        IOTWEBCONF_ASYNC_TCP_LOCK();
+        // -- Client sending faster than the loop takes it is dropped.
+        if (connection->_received.length() + length
+          > IOTWEBCONF_ASYNC_MAX_HEAD_LENGTH + IOTWEBCONF_ASYNC_MAX_BODY_LENGTH)
+        {
+          c->close();
+          return;
+        }
+        connection->_received.concat((const char*)data, length);
+      }, NULL);
+    client->onDisconnect(
+      [this, connection](void* arg, AsyncClient* c)
+      {
+        IOTWEBCONF_ASYNC_TCP_LOCK();
+        connection->_disconnected = true;
+      }, NULL);
+
+    IOTWEBCONF_ASYNC_TCP_LOCK();
+    connection->_nextConnection = this->_addedConnections;
+    this->_addedConnections = connection;
+  };
+};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,1039 @@
+/**
+ * IotWebConfAsyncWebServer.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <IotWebConfAsyncWebServer.h>
+
+// -- Same values as used by the WebServer.
+#ifndef CONTENT_LENGTH_UNKNOWN
+# define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
+#endif
+#ifndef CONTENT_LENGTH_NOT_SET
+# define CONTENT_LENGTH_NOT_SET ((size_t) -2)
+#endif
+
+namespace iotwebconf
+{
+
+// -- Answer to clients over the limits, sent from flash.
+static const char serviceUnavailableResponse[] PROGMEM =
+  "HTTP/1.1 503 Service Unavailable\r\n"
+  "Retry-After: 1\r\n"
+  "Content-Length: 0\r\n"
+  "Connection: close\r\n"
+  "\r\n";
+
+/**
+ * Arguments of the query string and of a form body are decoded on the fly
+ * while receiving, a non-form body is added as "plain" (like the WebServer
+ * does).
+ */
+class AsyncWebRequestArgs final : public IndexedWebRequestWrapper
+{
+public:
+  AsyncWebRequestArgs(WebRequestWrapper* request) :
+    IndexedWebRequestWrapper(request, false) { };
+  using IndexedWebRequestWrapper::addArg;
+};
+
+/**
+ * Content written is added to the output of the request as a chunk, and is
+ * sent by handleClient() in the pace the client is reading it. The request
+ * lets the stream go, when the connection is closed.
+ */
+class AsyncWebStream final : public WebStream
+{
+public:
+  AsyncWebStream(AsyncWebRequest* request) { this->_request = request; };
+  ~AsyncWebStream() { this->close(); };
+
+  bool connected() override { return this->_request != NULL; };
+  bool write(const char* data, size_t length) override
+  {
+    return (this->_request != NULL)
+      && this->_request->writeStream(data, length);
+  };
+  void close() override
+  {
+    if (this->_request != NULL)
+    {
+      this->_request->closeStream();
+    }
+  };
+
+private:
+  AsyncWebRequest* _request;
+  friend class AsyncWebRequest;
+};
+
+static const char* statusText(int code)
+{
+  switch (code)
+  {
+    case 200: return "OK";
+    case 204: return "No Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 408: return "Request Timeout";
+    case 413: return "Payload Too Large";
+    case 431: return "Request Header Fields Too Large";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+    default: return "";
+  }
+}
+
+static int base64Value(char c)
+{
+  if ((c >= 'A') && (c <= 'Z')) { return c - 'A'; }
+  if ((c >= 'a') && (c <= 'z')) { return c - 'a' + 26; }
+  if ((c >= '0') && (c <= '9')) { return c - '0' + 52; }
+  if (c == '+') { return 62; }
+  if (c == '/') { return 63; }
+  return -1;
+}
+
+/**
+ * Decode base64 into a zero terminated buffer. Returns false, if the
+ * input is invalid or does not fit into the buffer.
+ */
+static bool base64Decode(const char* in, char* out, size_t size)
+{
+  size_t length = 0;
+  unsigned long bits = 0;
+  int bitCount = 0;
+  for (; (*in != '\0') && (*in != '='); in++)
+  {
+    int value = base64Value(*in);
+    if (value < 0)
+    {
+      return false;
+    }
+    bits = (bits << 6) | value;
+    bitCount += 6;
+    if (bitCount >= 8)
+    {
+      bitCount -= 8;
+      if (length + 1 >= size)
+      {
+        return false;
+      }
+      out[length++] = (char)((bits >> bitCount) & 0xFF);
+    }
+  }
+  out[length] = '\0';
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+IPAddress AsyncWebRequest::localIP()
+{
+  return this->_connection->localIP();
+}
+
+bool AsyncWebRequest::authenticate(
+  const char * username, const char * password)
+{
+  const char* authorization = this->_authorization.c_str();
+  if (strncasecmp(authorization, "Basic ", 6) != 0)
+  {
+    return false;
+  }
+  char decoded[IOTWEBCONF_WORD_LEN + IOTWEBCONF_PASSWORD_LEN + 2];
+  if (!base64Decode(authorization + 6, decoded, sizeof(decoded)))
+  {
+    return false;
+  }
+  size_t usernameLength = strlen(username);
+  return (strncmp(decoded, username, usernameLength) == 0)
+    && (decoded[usernameLength] == ':')
+    && (strcmp(decoded + usernameLength + 1, password) == 0);
+}
+
+void AsyncWebRequest::requestAuthentication()
+{
+  this->sendHeader("WWW-Authenticate", "Basic realm=\"Login Required\"");
+  this->send(401, "text/plain", "Unauthorized", 12);
+}
+
+bool AsyncWebRequest::hasArg(const String& name)
+{
+  return this->_args->hasArg(name);
+}
+
+bool AsyncWebRequest::hasArg(const char* name, size_t nameLength)
+{
+  return this->_args->hasArg(name, nameLength);
+}
+
+String AsyncWebRequest::arg(const String name)
+{
+  return this->_args->arg(name);
+}
+
+String AsyncWebRequest::arg(const char* name, size_t nameLength)
+{
+  return this->_args->arg(name, nameLength);
+}
+
+int AsyncWebRequest::args()
+{
+  return this->_args->args();
+}
+
+String AsyncWebRequest::argName(int i)
+{
+  return this->_args->argName(i);
+}
+
+String AsyncWebRequest::argValue(int i)
+{
+  return this->_args->argValue(i);
+}
+
+size_t AsyncWebRequest::readArg(const String& name, char* buffer, size_t size)
+{
+  return this->_args->readArg(name, buffer, size);
+}
+
+size_t AsyncWebRequest::readArg(
+  const char* name, size_t nameLength, char* buffer, size_t size)
+{
+  return this->_args->readArg(name, nameLength, buffer, size);
+}
+
+/**
+ * Only the headers used by IotWebConf are kept from the request head.
+ */
+String AsyncWebRequest::header(const String& name)
+{
+  if (name.equalsIgnoreCase("Cookie"))
+  {
+    return this->_cookie;
+  }
+  if (name.equalsIgnoreCase("Authorization"))
+  {
+    return this->_authorization;
+  }
+  if (name.equalsIgnoreCase("Host"))
+  {
+    return this->_host;
+  }
+  return String("");
+}
+
+void AsyncWebRequest::sendHeader(
+  const String& name, const String& value, bool first)
+{
+  this->sendHeader(name.c_str(), value.c_str(), first);
+}
+
+void AsyncWebRequest::sendHeader(
+  const char* name, const char* value, bool first)
+{
+  if (strcasecmp(name, "Content-Length") == 0)
+  {
+    // -- Handlers might set the length as a header (WebServer accepts it).
+    this->_contentLength = strtoul(value, NULL, 10);
+    return;
+  }
+  if (first)
+  {
+    String header = name;
+    header += ": ";
+    header += value;
+    header += "\r\n";
+    this->_responseHeaders = header + this->_responseHeaders;
+  }
+  else
+  {
+    this->_responseHeaders += name;
+    this->_responseHeaders += ": ";
+    this->_responseHeaders += value;
+    this->_responseHeaders += "\r\n";
+  }
+}
+
+void AsyncWebRequest::setContentLength(const size_t contentLength)
+{
+  this->_contentLength = contentLength;
+}
+
+void AsyncWebRequest::send(
+  int code, const char* content_type, const String& content)
+{
+  this->send(code, content_type, content.c_str(), content.length());
+}
+
+void AsyncWebRequest::send(
+  int code, const char* content_type, const char* content, size_t length)
+{
+  this->_output = "HTTP/1.1 ";
+  this->_output += code;
+  this->_output += ' ';
+  this->_output += statusText(code);
+  this->_output += "\r\n";
+  if (content_type != NULL)
+  {
+    this->_output += "Content-Type: ";
+    this->_output += content_type;
+    this->_output += "\r\n";
+  }
+  if (this->_contentLength == CONTENT_LENGTH_NOT_SET)
+  {
+    this->_contentLength = length;
+  }
+  if (this->_contentLength != CONTENT_LENGTH_UNKNOWN)
+  {
+    this->_output += "Content-Length: ";
+    this->_output += (unsigned long)this->_contentLength;
+    this->_output += "\r\n";
+  }
+  else if (this->_http11)
+  {
+    this->_output += "Transfer-Encoding: chunked\r\n";
+    this->_chunked = true;
+  }
+  else
+  {
+    // -- End of the content can only be marked by closing the connection.
+    this->_keepAlive = false;
+  }
+  this->_output +=
+    this->_keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+  this->_output += this->_responseHeaders;
+  this->_output += "\r\n";
+  this->_responseHeaders = String();
+  if (!this->_chunked)
+  {
+    this->_output.concat(content, length);
+  }
+  else if (length > 0)
+  {
+    // -- An empty chunk would end the content.
+    this->sendContent(content, length);
+  }
+}
+
+void AsyncWebRequest::sendContent(const String& content)
+{
+  this->sendContent(content.c_str(), content.length());
+}
+
+void AsyncWebRequest::sendContent(const char* content, size_t length)
+{
+  this->startChunk(length);
+  this->_output.concat(content, length);
+  this->endChunk(length);
+}
+
+void AsyncWebRequest::sendContent_P(PGM_P content, size_t size)
+{
+  this->startChunk(size);
+  size_t remaining = size;
+  char buffer[64];
+  while (remaining > 0)
+  {
+    size_t length = remaining < sizeof(buffer) ? remaining : sizeof(buffer);
+    memcpy_P(buffer, content, length);
+    this->_output.concat(buffer, length);
+    content += length;
+    remaining -= length;
+  }
+  this->endChunk(size);
+}
+
+void AsyncWebRequest::startChunk(size_t size)
+{
+  if (this->_chunked)
+  {
+    this->_output += String((unsigned long)size, HEX);
+    this->_output += "\r\n";
+  }
+}
+
+/**
+ * Close a chunk started, an empty chunk is the last one.
+ */
+void AsyncWebRequest::endChunk(size_t size)
+{
+  if (this->_chunked)
+  {
+    this->_output += "\r\n";
+    this->_chunked = size > 0;
+  }
+}
+
+void AsyncWebRequest::stop()
+{
+  // -- Connection is closed when the response was sent.
+  this->_keepAlive = false;
+}
+
+WebStream* AsyncWebRequest::openStream(const char* content_type)
+{
+  // -- Only from the handler, and once.
+  if ((this->_state != StateReady) || (this->_stream != NULL))
+  {
+    return NULL;
+  }
+  this->sendHeader("Cache-Control", "no-cache");
+  this->_contentLength = CONTENT_LENGTH_UNKNOWN;
+  this->send(200, content_type, "", 0);
+  this->_stream = new AsyncWebStream(this);
+  return this->_stream;
+}
+
+/**
+ * Add content of the stream as a chunk. The part already sent is dropped
+ * from the output first, so the output only holds what the client has not
+ * read yet.
+ */
+bool AsyncWebRequest::writeStream(const char* data, size_t length)
+{
+  if (this->_outputSent == this->_output.length())
+  {
+    // -- Client was waiting, the timeout starts now.
+    this->_lastActivity = millis();
+  }
+  this->_output.remove(0, this->_outputSent);
+  this->_outputSent = 0;
+  // -- Content written by the handler itself is always taken.
+  if ((this->_state == StateStreaming)
+    && (this->_output.length() + length > IOTWEBCONF_ASYNC_STREAM_MAX_PENDING))
+  {
+    return false;
+  }
+  this->sendContent(data, length);
+  if (this->_state == StateStreaming)
+  {
+    this->flush();
+  }
+  return true;
+}
+
+/**
+ * End the content, the connection is kept alive or closed after sending
+ * the rest of the output, just like after a normal response.
+ */
+void AsyncWebRequest::closeStream()
+{
+  this->_stream->_request = NULL;
+  this->_stream = NULL;
+  if (this->_chunked)
+  {
+    this->sendContent("", 0);
+  }
+  if (this->_state == StateStreaming)
+  {
+    this->_lastActivity = millis();
+    this->_state = StateResponding;
+  }
+}
+
+void AsyncWebRequest::start(AsyncConnection* connection)
+{
+  this->reset();
+  this->_connection = connection;
+  this->_state = StateReadingHead;
+  this->_lastActivity = millis();
+  this->_phaseStart = this->_lastActivity;
+}
+
+/**
+ * Wait for the next request on the same connection.
+ */
+void AsyncWebRequest::next()
+{
+  unsigned int requestCount = this->_requestCount;
+  this->start(this->_connection);
+  this->_requestCount = requestCount;
+}
+
+/**
+ * Connection kept alive, but no new request started on it.
+ */
+bool AsyncWebRequest::isIdle() const
+{
+  return (this->_state == StateReadingHead) && (this->_requestCount > 0)
+    && (this->_head.length() == 0);
+}
+
+bool AsyncWebRequest::isTimedOut(unsigned long now) const
+{
+  switch (this->_state)
+  {
+    case StateReadingHead:
+      return this->isIdle()
+        ? now - this->_lastActivity > IOTWEBCONF_ASYNC_KEEP_ALIVE_MILLIS
+        : now - this->_phaseStart > IOTWEBCONF_ASYNC_HEAD_TIMEOUT_MILLIS;
+    case StateReadingBody:
+      return now - this->_phaseStart > IOTWEBCONF_ASYNC_BODY_TIMEOUT_MILLIS;
+    case StateResponding:
+    case StateStreaming:
+      // -- Only checked while there is output not yet sent.
+      return now - this->_lastActivity > IOTWEBCONF_ASYNC_CLIENT_TIMEOUT_MILLIS;
+    default:
+      return false;
+  }
+}
+
+void AsyncWebRequest::reset()
+{
+  if (this->_stream != NULL)
+  {
+    // -- Stream is owned by its user, it is only told the client is gone.
+    this->_stream->_request = NULL;
+    this->_stream = NULL;
+  }
+  this->_connection = NULL;
+  this->_state = StateFree;
+  this->_head = String();
+  this->_method = String();
+  this->_uri = String();
+  this->_host = String();
+  this->_authorization = String();
+  this->_cookie = String();
+  this->_http11 = false;
+  this->_keepAlive = false;
+  this->_requestCount = 0;
+  this->_formBody = false;
+  this->_bodyLength = 0;
+  this->_body = String();
+  delete this->_args;
+  this->_args = NULL;
+  this->_contentLength = CONTENT_LENGTH_NOT_SET;
+  this->_responseHeaders = String();
+  this->_chunked = false;
+  this->_output = String();
+  this->_outputSent = 0;
+}
+
+/**
+ * Process the next part of the request received. Returns false, if the
+ * request was rejected (an error response is prepared).
+ */
+bool AsyncWebRequest::receive(const char* data, size_t length)
+{
+  if (this->isIdle())
+  {
+    // -- Next request on a kept alive connection starts now.
+    this->_phaseStart = millis();
+  }
+  this->_lastActivity = millis();
+  if (this->_state == StateReadingHead)
+  {
+    // -- End of head might be split between the parts.
+    size_t searchFrom =
+      this->_head.length() < 3 ? 0 : this->_head.length() - 3;
+    size_t previousLength = this->_head.length();
+    this->_head.concat(data, length);
+    int headEnd = this->_head.indexOf("\r\n\r\n", searchFrom);
+    if (headEnd < 0)
+    {
+      if (this->_head.length() > IOTWEBCONF_ASYNC_MAX_HEAD_LENGTH)
+      {
+        this->fail(431);
+        return false;
+      }
+      return true;
+    }
+    headEnd += 4;
+    size_t used = headEnd - previousLength;
+    data += used;
+    length -= used;
+    if (headEnd > IOTWEBCONF_ASYNC_MAX_HEAD_LENGTH)
+    {
+      this->fail(431);
+      return false;
+    }
+    if (!this->parseHead())
+    {
+      return false;
+    }
+    this->_head = String();
+    if (this->_bodyLength == 0)
+    {
+      this->finishRequest();
+      // -- Pipelined requests are not supported, the client sends them
+      //    again on a new connection.
+      this->_keepAlive &= (length == 0);
+      return true;
+    }
+    this->_state = StateReadingBody;
+    this->_phaseStart = this->_lastActivity;
+  }
+
+  if (this->_state == StateReadingBody)
+  {
+    // -- Anything after the body is ignored, the connection is closed
+    //    after the response.
+    size_t bodyPart = length < this->_bodyLength ? length : this->_bodyLength;
+    this->_keepAlive &= (length == bodyPart);
+    if (this->_formBody)
+    {
+      this->_args->decodeForm(data, bodyPart);
+      if (this->_args->isFormTooLarge())
+      {
+        this->fail(413);
+        return false;
+      }
+    }
+    else
+    {
+      this->_body.concat(data, bodyPart);
+    }
+    this->_bodyLength -= bodyPart;
+    if (this->_bodyLength == 0)
+    {
+      this->finishRequest();
+    }
+  }
+  return true;
+}
+
+bool AsyncWebRequest::parseHead()
+{
+  const char* head = this->_head.c_str();
+  const char* lineEnd = strstr(head, "\r\n");
+  const char* methodEnd = strchr(head, ' ');
+  const char* targetEnd =
+    methodEnd == NULL ? NULL : strchr(methodEnd + 1, ' ');
+  if ((lineEnd == NULL) || (methodEnd == NULL) || (methodEnd == head)
+    || (targetEnd == NULL) || (targetEnd > lineEnd))
+  {
+    this->fail(400);
+    return false;
+  }
+  this->_method.concat(head, methodEnd - head);
+  const char* target = methodEnd + 1;
+  const char* query = (const char*)memchr(target, '?', targetEnd - target);
+  const char* pathEnd = query == NULL ? targetEnd : query;
+  this->_uri.concat(target, pathEnd - target);
+  this->_http11 = strncmp(targetEnd + 1, "HTTP/1.1", 8) == 0;
+  // -- HTTP/1.1 connections are persistent, unless told otherwise.
+  this->_keepAlive = this->_http11 && (IOTWEBCONF_ASYNC_KEEP_ALIVE_MILLIS > 0)
+    && (this->_requestCount + 1 < IOTWEBCONF_ASYNC_KEEP_ALIVE_MAX_REQUESTS);
+  bool keepAliveAllowed = this->_keepAlive || !this->_http11;
+
+  this->_args = new AsyncWebRequestArgs(this);
+  this->_args->setFormLimits(
+    IOTWEBCONF_ASYNC_MAX_FORM_LENGTH, IOTWEBCONF_ASYNC_MAX_ARGS);
+  if (query != NULL)
+  {
+    this->_args->decodeForm(query + 1, targetEnd - query - 1);
+    this->_args->decodeForm("&", 1);
+    if (this->_args->isFormTooLarge())
+    {
+      this->fail(413);
+      return false;
+    }
+  }
+
+  // -- Only the headers needed are kept.
+  const char* line = lineEnd + 2;
+  while (strncmp(line, "\r\n", 2) != 0)
+  {
+    lineEnd = strstr(line, "\r\n");
+    if (lineEnd == NULL)
+    {
+      this->fail(400);
+      return false;
+    }
+    const char* colon = (const char*)memchr(line, ':', lineEnd - line);
+    if (colon != NULL)
+    {
+      size_t nameLength = colon - line;
+      const char* value = colon + 1;
+      while ((value < lineEnd) && (*value == ' '))
+      {
+        value++;
+      }
+      size_t valueLength = lineEnd - value;
+      if ((nameLength == 4) && (strncasecmp(line, "Host", 4) == 0))
+      {
+        this->_host.concat(value, valueLength);
+      }
+      else if ((nameLength == 13)
+        && (strncasecmp(line, "Authorization", 13) == 0))
+      {
+        this->_authorization.concat(value, valueLength);
+      }
+      else if ((nameLength == 6) && (strncasecmp(line, "Cookie", 6) == 0))
+      {
+        this->_cookie.concat(value, valueLength);
+      }
+      else if ((nameLength == 12)
+        && (strncasecmp(line, "Content-Type", 12) == 0))
+      {
+        this->_formBody = (strncasecmp(
+          value, "application/x-www-form-urlencoded", 33) == 0);
+      }
+      else if ((nameLength == 14)
+        && (strncasecmp(line, "Content-Length", 14) == 0))
+      {
+        this->_bodyLength = strtoul(value, NULL, 10);
+      }
+      else if ((nameLength == 10)
+        && (strncasecmp(line, "Connection", 10) == 0))
+      {
+        if (strncasecmp(value, "close", 5) == 0)
+        {
+          this->_keepAlive = false;
+        }
+        else if (strncasecmp(value, "keep-alive", 10) == 0)
+        {
+          this->_keepAlive = keepAliveAllowed
+            && (IOTWEBCONF_ASYNC_KEEP_ALIVE_MILLIS > 0)
+            && (this->_requestCount + 1 < IOTWEBCONF_ASYNC_KEEP_ALIVE_MAX_REQUESTS);
+        }
+      }
+    }
+    line = lineEnd + 2;
+  }
+
+  if (!this->_formBody && (this->_bodyLength > IOTWEBCONF_ASYNC_MAX_BODY_LENGTH))
+  {
+    this->fail(413);
+    return false;
+  }
+  return true;
+}
+
+void AsyncWebRequest::finishRequest()
+{
+  if (this->_body.length() > 0)
+  {
+    this->_args->addArg(
+      "plain", 5, this->_body.c_str(), this->_body.length());
+    this->_body = String();
+  }
+  this->_args->finishForm();
+  this->_state = StateReady;
+}
+
+/**
+ * Write as much of the response as the connection accepts. Returns true,
+ * when the whole response was written.
+ */
+bool AsyncWebRequest::flush()
+{
+  while (this->_outputSent < this->_output.length())
+  {
+    size_t space = this->_connection->space();
+    if (space == 0)
+    {
+      return false;
+    }
+    size_t remaining = this->_output.length() - this->_outputSent;
+    size_t written = this->_connection->write(
+      this->_output.c_str() + this->_outputSent,
+      space < remaining ? space : remaining);
+    if (written == 0)
+    {
+      return false;
+    }
+    this->_outputSent += written;
+    this->_lastActivity = millis();
+  }
+  return true;
+}
+
+void AsyncWebRequest::fail(int code)
+{
+  // -- Rest of the request cannot be told apart from a next one.
+  this->_keepAlive = false;
+  this->_contentLength = CONTENT_LENGTH_NOT_SET;
+  this->_responseHeaders = String();
+  const char* text = statusText(code);
+  this->send(code, "text/plain", text, strlen(text));
+  this->_state = StateResponding;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+AsyncWebServerWrapper::AsyncWebServerWrapper(
+  AsyncTransport* transport, uint16_t port)
+{
+  this->_transport = transport;
+  this->_port = port;
+}
+
+void AsyncWebServerWrapper::on(
+  const char* uri, const char* method,
+  std::function<void(WebRequestWrapper* webRequestWrapper)> handler)
+{
+  Route* route = new Route();
+  route->uri = uri;
+  route->method = method;
+  route->handler = handler;
+  route->nextRoute = NULL;
+  if (this->_firstRoute == NULL)
+  {
+    this->_firstRoute = route;
+    return;
+  }
+  Route* current = this->_firstRoute;
+  while (current->nextRoute != NULL)
+  {
+    current = current->nextRoute;
+  }
+  current->nextRoute = route;
+}
+
+void AsyncWebServerWrapper::begin()
+{
+  this->_transport->begin(this->_port, this);
+}
+
+bool AsyncWebServerWrapper::handleClient()
+{
+  this->_transport->poll();
+
+  // -- One request is served in a call, clients are taken in turns.
+  bool served = false;
+  for (int i = 0; i < IOTWEBCONF_ASYNC_MAX_CLIENTS; i++)
+  {
+    int index = (this->_nextRequest + i) % IOTWEBCONF_ASYNC_MAX_CLIENTS;
+    if (this->_requests[index]._state == AsyncWebRequest::StateReady)
+    {
+      this->_nextRequest = (index + 1) % IOTWEBCONF_ASYNC_MAX_CLIENTS;
+      this->dispatch(&this->_requests[index]);
+      served = true;
+      break;
+    }
+  }
+
+  unsigned long now = millis();
+  for (int i = 0; i < IOTWEBCONF_ASYNC_MAX_CLIENTS; i++)
+  {
+    AsyncWebRequest* request = &this->_requests[i];
+    if ((request->_state == AsyncWebRequest::StateResponding)
+      && request->flush())
+    {
+      if (request->_keepAlive)
+      {
+        request->next();
+      }
+      else
+      {
+        this->close(request);
+      }
+    }
+    else if ((request->_state == AsyncWebRequest::StateStreaming)
+      && request->flush())
+    {
+      // -- Waiting for more content of the stream.
+    }
+    else if (request->isTimedOut(now))
+    {
+      // -- Client is too slow sending its request, or stopped reading the
+      //    response, or did not use its kept alive connection.
+      this->close(request);
+    }
+  }
+  return served;
+}
+
+void AsyncWebServerWrapper::onConnect(AsyncConnection* connection)
+{
+  AsyncWebRequest* request = this->find(NULL);
+  if (request == NULL)
+  {
+    // -- A kept alive connection is cheaper to open again (if ever) than
+    //    refusing a client waiting for an answer.
+    request = this->findReplaceable();
+    if (request == NULL)
+    {
+      // -- No more clients can be served now.
+      this->reject(connection);
+      return;
+    }
+    this->close(request);
+  }
+  request->start(connection);
+}
+
+void AsyncWebServerWrapper::onData(
+  AsyncConnection* connection, const char* data, size_t length)
+{
+  AsyncWebRequest* request = this->find(connection);
+  if (request == NULL)
+  {
+    return;
+  }
+  if ((request->_state == AsyncWebRequest::StateReadingHead)
+    || (request->_state == AsyncWebRequest::StateReadingBody))
+  {
+    request->receive(data, length);
+    if ((request->_state == AsyncWebRequest::StateReady)
+      && (this->countReady() > IOTWEBCONF_ASYNC_MAX_QUEUED))
+    {
+      // -- Would wait too long for its turn, better to try again later.
+      AsyncConnection* requestConnection = request->_connection;
+      request->reset();
+      this->reject(requestConnection);
+    }
+  }
+  else
+  {
+    // -- Pipelined request, see receive().
+    request->_keepAlive = false;
+  }
+}
+
+void AsyncWebServerWrapper::onDisconnect(AsyncConnection* connection)
+{
+  AsyncWebRequest* request = this->find(connection);
+  if (request != NULL)
+  {
+    request->reset();
+  }
+}
+
+AsyncWebRequest* AsyncWebServerWrapper::find(AsyncConnection* connection)
+{
+  for (int i = 0; i < IOTWEBCONF_ASYNC_MAX_CLIENTS; i++)
+  {
+    if (this->_requests[i]._connection == connection)
+    {
+      return &this->_requests[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Find a place to be given up for a new client: the client sending its
+ * request head for the longest time (if too long already), or else the
+ * kept alive connection not used for the longest time.
+ */
+AsyncWebRequest* AsyncWebServerWrapper::findReplaceable()
+{
+  AsyncWebRequest* oldestIdle = NULL;
+  AsyncWebRequest* slowest = NULL;
+  unsigned long now = millis();
+  for (int i = 0; i < IOTWEBCONF_ASYNC_MAX_CLIENTS; i++)
+  {
+    AsyncWebRequest* request = &this->_requests[i];
+    if (request->isIdle())
+    {
+      if ((oldestIdle == NULL)
+        || (now - request->_lastActivity > now - oldestIdle->_lastActivity))
+      {
+        oldestIdle = request;
+      }
+    }
+    else if ((request->_state == AsyncWebRequest::StateReadingHead)
+      && (now - request->_phaseStart > IOTWEBCONF_ASYNC_BUSY_HEAD_TIMEOUT_MILLIS)
+      && ((slowest == NULL)
+        || (now - request->_phaseStart > now - slowest->_phaseStart)))
+    {
+      slowest = request;
+    }
+  }
+  return slowest != NULL ? slowest : oldestIdle;
+}
+
+int AsyncWebServerWrapper::countReady()
+{
+  int count = 0;
+  for (int i = 0; i < IOTWEBCONF_ASYNC_MAX_CLIENTS; i++)
+  {
+    if (this->_requests[i]._state == AsyncWebRequest::StateReady)
+    {
+      count++;
+    }
+  }
+  return count;
+}
+
+/**
+ * Answer 503 and close the connection. The answer is copied from flash in
+ * small parts, what does not fit into the send buffer is dropped.
+ */
+void AsyncWebServerWrapper::reject(AsyncConnection* connection)
+{
+  PGM_P response = serviceUnavailableResponse;
+  size_t remaining = sizeof(serviceUnavailableResponse) - 1;
+  char buffer[32];
+  while (remaining > 0)
+  {
+    size_t length = remaining < sizeof(buffer) ? remaining : sizeof(buffer);
+    size_t space = connection->space();
+    length = space < length ? space : length;
+    memcpy_P(buffer, response, length);
+    size_t written = length == 0 ? 0 : connection->write(buffer, length);
+    if (written == 0)
+    {
+      break;
+    }
+    response += written;
+    remaining -= written;
+  }
+  connection->close();
+}
+
+void AsyncWebServerWrapper::dispatch(AsyncWebRequest* request)
+{
+  Route* route = this->_firstRoute;
+  while ((route != NULL)
+    && ((strcmp(route->uri, request->_uri.c_str()) != 0)
+      || ((route->method != NULL)
+        && (strcmp(route->method, request->_method.c_str()) != 0))))
+  {
+    route = route->nextRoute;
+  }
+  if (route != NULL)
+  {
+    route->handler(request);
+  }
+  else if (this->_notFoundHandler != NULL)
+  {
+    this->_notFoundHandler(request);
+  }
+  else
+  {
+    request->send(404, "text/plain", "Not found", 9);
+  }
+  request->_requestCount++;
+  // -- Only the response is kept from now on.
+  delete request->_args;
+  request->_args = NULL;
+  if (request->_stream != NULL)
+  {
+    // -- Rest of the response comes later.
+    request->_state = AsyncWebRequest::StateStreaming;
+    return;
+  }
+  if (request->_chunked)
+  {
+    // -- Handler did not send the last chunk.
+    request->sendContent("", 0);
+  }
+  // -- Nothing was sent, the client can only tell by the closing.
+  request->_keepAlive &= (request->_output.length() > 0);
+  request->_state = AsyncWebRequest::StateResponding;
+}
+
+void AsyncWebServerWrapper::close(AsyncWebRequest* request)
+{
+  request->_connection->close();
+  request->reset();
+}
+
+} // end namespace
@@ -0,0 +1,259 @@
+/**
+ * IotWebConfAsyncWebServer.h -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfAsyncWebServer_h
+#define IotWebConfAsyncWebServer_h
+
+#include <Arduino.h>
+#include <functional>
+#include <IPAddress.h>
+#include <IotWebConfSettings.h>
+#include <IotWebConfWebServerWrapper.h>
+
+namespace iotwebconf
+{
+
+class AsyncWebRequestArgs;
+class AsyncWebStream;
+
+/**
+ * A TCP connection of an AsyncTransport.
+ */
+class AsyncConnection
+{
+public:
+  /**
+   * Count of bytes that can be written right now without blocking.
+   */
+  virtual size_t space() = 0;
+  /**
+   * Write at most space() bytes, returns the count of bytes written.
+   */
+  virtual size_t write(const char* data, size_t length) = 0;
+  /**
+   * Close the connection. The connection must not be used after this call,
+   *   and no more events are delivered for it.
+   */
+  virtual void close() = 0;
+  virtual IPAddress localIP() = 0;
+};
+
+/**
+ * Receives the events of an AsyncTransport.
+ */
+class AsyncConnectionHandler
+{
+public:
+  virtual void onConnect(AsyncConnection* connection) = 0;
+  virtual void onData(
+    AsyncConnection* connection, const char* data, size_t length) = 0;
+  /**
+   * Connection was closed by the client (or by an error). The connection
+   *   must not be used after this call.
+   */
+  virtual void onDisconnect(AsyncConnection* connection) = 0;
+};
+
+/**
+ * A callback (event) driven TCP stack. Events may arrive at any time in the
+ * stack, but these are delivered to the handler only from within poll(), so
+ * that the handler always runs in the context of the loop.
+ */
+class AsyncTransport
+{
+public:
+  virtual bool begin(uint16_t port, AsyncConnectionHandler* handler) = 0;
+  virtual void poll() = 0;
+};
+
+/**
+ * A request received by the AsyncWebServerWrapper. The response is
+ * collected in memory, and is sent to the client by the server in the
+ * pace the client is reading it. The same object receives the next request
+ * when the connection is kept alive.
+ */
+class AsyncWebRequest : public WebRequestWrapper
+{
+public:
+  const String hostHeader() const override { return this->_host; };
+  IPAddress localIP() override;
+  const String uri() const override { return this->_uri; };
+  size_t readHostHeader(char* buffer, size_t size) override
+  {
+    return copyValue(this->_host, buffer, size);
+  };
+  size_t readUri(char* buffer, size_t size) override
+  {
+    return copyValue(this->_uri, buffer, size);
+  };
+  const String& method() const { return this->_method; };
+  bool authenticate(const char * username, const char * password) override;
+  void requestAuthentication() override;
+  bool hasArg(const String& name) override;
+  bool hasArg(const char* name, size_t nameLength) override;
+  String arg(const String name) override;
+  String arg(const char* name, size_t nameLength) override;
+  int args() override;
+  String argName(int i) override;
+  String argValue(int i) override;
+  size_t readArg(const String& name, char* buffer, size_t size) override;
+  size_t readArg(
+    const char* name, size_t nameLength, char* buffer, size_t size) override;
+  using WebRequestWrapper::hasArg;
+  using WebRequestWrapper::arg;
+  using WebRequestWrapper::readArg;
+  String header(const String& name) override;
+  void sendHeader(const String& name, const String& value, bool first = false) override;
+  void sendHeader(const char* name, const char* value, bool first = false) override;
+  void setContentLength(const size_t contentLength) override;
+  void send(int code, const char* content_type = NULL, const String& content = String("")) override;
+  void send(
+    int code, const char* content_type, const char* content, size_t length) override;
+  void sendContent(const String& content) override;
+  void sendContent(const char* content, size_t length) override;
+  void sendContent_P(PGM_P content, size_t size) override;
+  void stop() override;
+  WebStream* openStream(const char* content_type) override;
+
+private:
+  enum State
+  {
+    StateFree,
+    StateReadingHead,
+    StateReadingBody,
+    StateReady,
+    StateResponding,
+    // -- Handler returned, content is sent through the stream.
+    StateStreaming
+  };
+
+  AsyncConnection* _connection = NULL;
+  State _state = StateFree;
+  unsigned long _lastActivity = 0;
+  // -- Start of receiving the head or the body, for the timeouts.
+  unsigned long _phaseStart = 0;
+  String _head;
+  String _method;
+  String _uri;
+  String _host;
+  String _authorization;
+  String _cookie;
+  bool _http11 = false;
+  // -- Connection is kept open after the response for the next request.
+  bool _keepAlive = false;
+  // -- Requests served on the connection so far.
+  unsigned int _requestCount = 0;
+  bool _formBody = false;
+  // -- Bytes of the body not yet received.
+  size_t _bodyLength = 0;
+  String _body;
+  AsyncWebRequestArgs* _args = NULL;
+  size_t _contentLength = 0;
+  String _responseHeaders;
+  // -- Content is sent with chunked encoding, the last chunk not yet sent.
+  bool _chunked = false;
+  String _output;
+  size_t _outputSent = 0;
+  AsyncWebStream* _stream = NULL;
+
+  void start(AsyncConnection* connection);
+  void next();
+  void reset();
+  bool isIdle() const;
+  bool isTimedOut(unsigned long now) const;
+  void startChunk(size_t size);
+  void endChunk(size_t size);
+  bool receive(const char* data, size_t length);
+  bool parseHead();
+  void finishRequest();
+  bool flush();
+  void fail(int code);
+  bool writeStream(const char* data, size_t length);
+  void closeStream();
+  friend class AsyncWebServerWrapper;
+  friend class AsyncWebStream;
+};
+
+/**
+ * An event driven web server on top of an AsyncTransport. Requests are
+ * received by all clients in parallel, handlers are called from
+ * handleClient() (one request in a call), and responses are sent while the
+ * clients are reading them. So a slow client does not block the loop, nor
+ * the other clients.
+ * A handler must send the whole response before returning (or open a stream
+ * for the rest of it), the response is kept in memory until it is sent, so
+ * the count of clients served in parallel is limited by
+ * IOTWEBCONF_ASYNC_MAX_CLIENTS. A streaming client keeps its place until the
+ * stream is closed. Connections are kept
+ * alive after the response (see IOTWEBCONF_ASYNC_KEEP_ALIVE_MILLIS), but an
+ * idle connection (or a client sending too slowly) gives its place up to a
+ * new client.
+ * Clients over the limits (see IOTWEBCONF_ASYNC_MAX_QUEUED) are answered
+ * "503 Service Unavailable" right away, without using any heap.
+ */
+class AsyncWebServerWrapper : public WebServerWrapper, private AsyncConnectionHandler
+{
+public:
+  AsyncWebServerWrapper(AsyncTransport* transport, uint16_t port = 80);
+
+  /**
+   * Register a handler for an URI. With method NULL, all methods are
+   *   accepted.
+   */
+  void on(
+    const char* uri, std::function<void(WebRequestWrapper* webRequestWrapper)> handler)
+  {
+    this->on(uri, NULL, handler);
+  };
+  void on(
+    const char* uri, const char* method,
+    std::function<void(WebRequestWrapper* webRequestWrapper)> handler);
+  void onNotFound(
+    std::function<void(WebRequestWrapper* webRequestWrapper)> handler)
+  {
+    this->_notFoundHandler = handler;
+  };
+
+  bool handleClient() override;
+  void begin() override;
+
+private:
+  typedef struct Route
+  {
+    const char* uri;
+    const char* method;
+    std::function<void(WebRequestWrapper* webRequestWrapper)> handler;
+    struct Route* nextRoute;
+  } Route;
+
+  AsyncTransport* _transport;
+  uint16_t _port;
+  Route* _firstRoute = NULL;
+  std::function<void(WebRequestWrapper* webRequestWrapper)> _notFoundHandler = NULL;
+  AsyncWebRequest _requests[IOTWEBCONF_ASYNC_MAX_CLIENTS];
+  int _nextRequest = 0;
+
+  void onConnect(AsyncConnection* connection) override;
+  void onData(
+    AsyncConnection* connection, const char* data, size_t length) override;
+  void onDisconnect(AsyncConnection* connection) override;
+
+  AsyncWebRequest* find(AsyncConnection* connection);
+  AsyncWebRequest* findReplaceable();
+  int countReady();
+  void reject(AsyncConnection* connection);
+  void dispatch(AsyncWebRequest* request);
+  void close(AsyncWebRequest* request);
+};
+
+} // end namespace
+
+#endif
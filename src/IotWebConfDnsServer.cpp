@@ -0,0 +1,153 @@
+/**
+ * IotWebConfDnsServer.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <IotWebConfDnsServer.h>
+
+// -- Header flags.
+#define IOTWEBCONF_DNS_QR 0x80
+#define IOTWEBCONF_DNS_OPCODE 0x78
+#define IOTWEBCONF_DNS_AA 0x04
+#define IOTWEBCONF_DNS_RD 0x01
+
+#define IOTWEBCONF_DNS_TYPE_A 1
+#define IOTWEBCONF_DNS_TYPE_ANY 255
+
+namespace iotwebconf
+{
+
+CaptiveDnsServer::CaptiveDnsServer()
+{
+  // -- Name is a pointer to the question (at offset 12), class IN.
+  static const byte answerTemplate[IOTWEBCONF_DNS_ANSWER_SIZE] = {
+    0xC0, 0x0C, 0x00, IOTWEBCONF_DNS_TYPE_A, 0x00, 0x01,
+    0, 0, 0, 0, // -- TTL
+    0x00, 0x04,
+    0, 0, 0, 0 }; // -- Address
+  memcpy(this->_answer, answerTemplate, IOTWEBCONF_DNS_ANSWER_SIZE);
+  this->setTTL(IOTWEBCONF_DNS_TTL);
+}
+
+bool CaptiveDnsServer::start(const IPAddress& ip, uint16_t port)
+{
+  for (int i = 0; i < 4; i++)
+  {
+    this->_answer[12 + i] = ip[i];
+  }
+  this->_started = (this->_udp.begin(port) == 1);
+  return this->_started;
+}
+
+void CaptiveDnsServer::stop()
+{
+  this->_udp.stop();
+  this->_started = false;
+}
+
+void CaptiveDnsServer::setTTL(uint32_t ttl)
+{
+  this->_answer[6] = ttl >> 24;
+  this->_answer[7] = ttl >> 16;
+  this->_answer[8] = ttl >> 8;
+  this->_answer[9] = ttl;
+}
+
+void CaptiveDnsServer::processNextRequest()
+{
+  this->processRequests(this->_timeBudgetMicros);
+}
+
+int CaptiveDnsServer::processRequests(unsigned long budgetMicros)
+{
+  if (!this->_started)
+  {
+    return 0;
+  }
+  int processed = 0;
+  unsigned long start = micros();
+  do
+  {
+    if (!this->processPacket())
+    {
+      // -- No more queries waiting.
+      break;
+    }
+    processed++;
+  } while (micros() - start < budgetMicros);
+  return processed;
+}
+
+/**
+ * Answer the next query waiting, if any. Returns false, if there was no
+ * query waiting.
+ */
+bool CaptiveDnsServer::processPacket()
+{
+  int packetSize = this->_udp.parsePacket();
+  if (packetSize <= 0)
+  {
+    return false;
+  }
+  size_t length = this->_udp.read(this->_buffer, sizeof(this->_buffer));
+  byte* header = this->_buffer;
+
+  // -- Only standard queries with a single question are answered,
+  //    anything else is dropped.
+  if ((length < IOTWEBCONF_DNS_HEADER_SIZE)
+    || ((header[2] & (IOTWEBCONF_DNS_QR | IOTWEBCONF_DNS_OPCODE)) != 0)
+    || (header[4] != 0) || (header[5] != 1)
+    || (header[6] != 0) || (header[7] != 0))
+  {
+    return true;
+  }
+  size_t pos = IOTWEBCONF_DNS_HEADER_SIZE;
+  while ((pos < length) && (this->_buffer[pos] != 0))
+  {
+    if ((this->_buffer[pos] & 0xC0) != 0)
+    {
+      // -- Compression is not expected in a question.
+      return true;
+    }
+    pos += this->_buffer[pos] + 1;
+  }
+  // -- Terminating zero, type and class.
+  pos += 5;
+  if ((pos > length)
+    || (pos + IOTWEBCONF_DNS_ANSWER_SIZE > sizeof(this->_buffer)))
+  {
+    return true;
+  }
+  unsigned int type = (this->_buffer[pos - 4] << 8) | this->_buffer[pos - 3];
+  bool answered =
+    (type == IOTWEBCONF_DNS_TYPE_A) || (type == IOTWEBCONF_DNS_TYPE_ANY);
+
+  // -- Reply is built in place: header is altered, additional records
+  //    (e.g. EDNS) of the query are cut, and the answer is appended.
+  header[2] = IOTWEBCONF_DNS_QR | IOTWEBCONF_DNS_AA
+    | (header[2] & IOTWEBCONF_DNS_RD);
+  header[3] = 0;
+  header[7] = answered ? 1 : 0;
+  header[8] = 0;
+  header[9] = 0;
+  header[10] = 0;
+  header[11] = 0;
+  if (answered)
+  {
+    memcpy(this->_buffer + pos, this->_answer, IOTWEBCONF_DNS_ANSWER_SIZE);
+    pos += IOTWEBCONF_DNS_ANSWER_SIZE;
+  }
+
+  this->_udp.beginPacket(this->_udp.remoteIP(), this->_udp.remotePort());
+  this->_udp.write(this->_buffer, pos);
+  this->_udp.endPacket();
+  return true;
+}
+
+} // end namespace
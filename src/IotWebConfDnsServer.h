@@ -0,0 +1,100 @@
+/**
+ * IotWebConfDnsServer.h -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfDnsServer_h
+#define IotWebConfDnsServer_h
+
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <WiFiUdp.h>
+#include <IotWebConfSettings.h>
+
+// -- Size of a DNS header, and of the answer appended to the question.
+#define IOTWEBCONF_DNS_HEADER_SIZE 12
+#define IOTWEBCONF_DNS_ANSWER_SIZE 16
+
+namespace iotwebconf
+{
+
+/**
+ * IotWebConf calls processRequests() of this wrapper from the DNS task of its
+ * loop scheduler (see doLoop()), with the time budget of the task. Use it to
+ * provide your own DNS server implementation: overriding
+ * processNextRequest() is enough, processRequests() calls it by default.
+ */
+class DnsServerWrapper
+{
+public:
+  virtual void processNextRequest() = 0;
+  /**
+   * Process requests for at most the time given (in microseconds). Called
+   *   by the loop scheduler of IotWebConf. Returns the number of requests
+   *   processed, as far as known. The default implementation processes
+   *   only the next request, and returns 0, as processNextRequest() does
+   *   not tell whether there was one.
+   */
+  virtual int processRequests(unsigned long budgetMicros)
+  {
+    this->processNextRequest();
+    return 0;
+  };
+};
+
+/**
+ * A captive portal DNS server, that answers every A query with the address
+ * of the device. Unlike DNSServer, all the queries waiting are answered in
+ * one processRequests() call (within the time budget given by IotWebConf),
+ * so that a burst of queries from newly joined clients does not need a loop
+ * pass per query.
+ * The answer record is prepared on start(), only the question of the query
+ * is copied to the reply.
+ * Queries other than A (e.g. AAAA) are answered without records, so that
+ * clients do not wait for a timeout.
+ */
+class CaptiveDnsServer : public DnsServerWrapper
+{
+public:
+  CaptiveDnsServer();
+
+  bool start(const IPAddress& ip, uint16_t port = IOTWEBCONF_DNS_PORT);
+  void stop();
+  /**
+   * Time to live of the answers in seconds. Keep it short, so that clients
+   *   do not hold on to the address of the portal after it was gone.
+   */
+  void setTTL(uint32_t ttl);
+  /**
+   * Maximal time spent with answering queries in one processNextRequest()
+   *   call, for code calling it directly. At least one query is always
+   *   answered. IotWebConf does not use this: it calls processRequests()
+   *   with the budget of its DNS loop task.
+   */
+  void setTimeBudget(unsigned long timeBudgetMicros)
+  {
+    this->_timeBudgetMicros = timeBudgetMicros;
+  }
+
+  void processNextRequest() override;
+  int processRequests(unsigned long budgetMicros) override;
+
+private:
+  WiFiUDP _udp;
+  bool _started = false;
+  unsigned long _timeBudgetMicros = IOTWEBCONF_DNS_TIME_BUDGET_MICROS;
+  byte _answer[IOTWEBCONF_DNS_ANSWER_SIZE];
+  byte _buffer[IOTWEBCONF_DNS_MAX_PACKET_SIZE];
+
+  bool processPacket();
+};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,174 @@
+/**
+ * IotWebConfEventSource.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <IotWebConfEventSource.h>
+
+namespace iotwebconf
+{
+
+// -- A comment line, ignored by the browser.
+static const char keepAliveMessage[] = ":\n\n";
+
+/**
+ * Event is formatted once, and the same message is written to every viewer.
+ */
+static String formatEvent(const char* event, const char* data)
+{
+  String message;
+  message.reserve(strlen(data) + (event == NULL ? 0 : strlen(event)) + 16);
+  if (event != NULL)
+  {
+    message += F("event: ");
+    message += event;
+    message += '\n';
+  }
+  message += F("data: ");
+  message += data;
+  message += F("\n\n");
+  return message;
+}
+
+EventSource::~EventSource()
+{
+  this->close();
+}
+
+WebStream* EventSource::open(WebRequestWrapper* webRequestWrapper)
+{
+  WebStream* viewer = webRequestWrapper->openStream("text/event-stream");
+  if (viewer == NULL)
+  {
+    webRequestWrapper->send(501, "text/plain", "Not Implemented", 15);
+    return NULL;
+  }
+
+  int place = -1;
+  for (int i = 0; i < IOTWEBCONF_EVENT_MAX_VIEWERS; i++)
+  {
+    if ((this->_viewers[i] == NULL) || !this->_viewers[i]->connected())
+    {
+      place = i;
+      break;
+    }
+  }
+  if (place < 0)
+  {
+    place = this->_nextViewer;
+  }
+  this->drop(place);
+  this->_nextViewer = (place + 1) % IOTWEBCONF_EVENT_MAX_VIEWERS;
+  this->_viewers[place] = viewer;
+
+  char retry[24];
+  snprintf(retry, sizeof(retry), "retry: %lu\n\n",
+    (unsigned long)IOTWEBCONF_EVENT_RETRY_MILLIS);
+  return this->write(place, retry, strlen(retry)) ? viewer : NULL;
+}
+
+void EventSource::send(const char* event, const char* data)
+{
+  if (!this->hasViewers())
+  {
+    return;
+  }
+  String message = formatEvent(event, data);
+  for (int i = 0; i < IOTWEBCONF_EVENT_MAX_VIEWERS; i++)
+  {
+    if (this->_viewers[i] != NULL)
+    {
+      this->write(i, message.c_str(), message.length());
+    }
+  }
+  this->_lastSent = millis();
+}
+
+bool EventSource::send(WebStream* viewer, const char* event, const char* data)
+{
+  for (int i = 0; i < IOTWEBCONF_EVENT_MAX_VIEWERS; i++)
+  {
+    if ((viewer != NULL) && (this->_viewers[i] == viewer))
+    {
+      String message = formatEvent(event, data);
+      return this->write(i, message.c_str(), message.length());
+    }
+  }
+  return false;
+}
+
+bool EventSource::hasViewers()
+{
+  for (int i = 0; i < IOTWEBCONF_EVENT_MAX_VIEWERS; i++)
+  {
+    if (this->_viewers[i] != NULL)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void EventSource::loop()
+{
+  bool hasViewers = false;
+  for (int i = 0; i < IOTWEBCONF_EVENT_MAX_VIEWERS; i++)
+  {
+    if ((this->_viewers[i] != NULL) && !this->_viewers[i]->connected())
+    {
+      this->drop(i);
+    }
+    hasViewers |= (this->_viewers[i] != NULL);
+  }
+
+  unsigned long now = millis();
+  if (hasViewers && (now - this->_lastSent >= IOTWEBCONF_EVENT_KEEP_ALIVE_MILLIS))
+  {
+    for (int i = 0; i < IOTWEBCONF_EVENT_MAX_VIEWERS; i++)
+    {
+      if (this->_viewers[i] != NULL)
+      {
+        this->write(i, keepAliveMessage, sizeof(keepAliveMessage) - 1);
+      }
+    }
+    this->_lastSent = now;
+  }
+}
+
+void EventSource::close()
+{
+  for (int i = 0; i < IOTWEBCONF_EVENT_MAX_VIEWERS; i++)
+  {
+    this->drop(i);
+  }
+}
+
+/**
+ * A viewer not taking the whole message is dropped, as it would receive a
+ * broken event otherwise.
+ */
+bool EventSource::write(int i, const char* message, size_t length)
+{
+  if (this->_viewers[i]->write(message, length))
+  {
+    return true;
+  }
+  IOTWEBCONF_DEBUG_LINE(F("Event viewer dropped."));
+  this->drop(i);
+  return false;
+}
+
+void EventSource::drop(int i)
+{
+  // -- Deleting the stream ends the response.
+  delete this->_viewers[i];
+  this->_viewers[i] = NULL;
+}
+
+} // end namespace
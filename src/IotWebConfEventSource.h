@@ -0,0 +1,76 @@
+/**
+ * IotWebConfEventSource.h -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfEventSource_h
+#define IotWebConfEventSource_h
+
+#include <Arduino.h>
+#include <IotWebConfSettings.h>
+#include <IotWebConfWebServerWrapper.h>
+
+namespace iotwebconf
+{
+
+/**
+ * Server-Sent Events (text/event-stream, as read by the EventSource of the
+ * browsers) for a few viewers. Every viewer keeps its connection open, and
+ * an event is written to all of them as it is, so the cost of an event is
+ * the size of its data, nothing is rendered again.
+ * A viewer not able to take an event (gone, or not reading fast enough) is
+ * dropped. The browser connects again after IOTWEBCONF_EVENT_RETRY_MILLIS,
+ * and should be given a fresh snapshot then.
+ */
+class EventSource
+{
+public:
+  ~EventSource();
+
+  /**
+   * Start sending events to the client of the request. Returns the new
+   *   viewer (e.g. for sending an initial snapshot to it), or NULL, if the
+   *   web server is not able to keep the connection. When all places are
+   *   taken, the viewer connected first is dropped.
+   */
+  WebStream* open(WebRequestWrapper* webRequestWrapper);
+  /**
+   * Send an event to all viewers. The data must be a single line (e.g.
+   *   JSON), with event NULL the event is a "message".
+   */
+  void send(const char* event, const char* data);
+  /**
+   * Send an event to one viewer only. Returns false, if the viewer was
+   *   dropped.
+   */
+  bool send(WebStream* viewer, const char* event, const char* data);
+  bool hasViewers();
+  /**
+   * Drop viewers gone, and keep the connections of the others alive.
+   *   Should be called regularly (IotWebConf calls it from doLoop()).
+   */
+  void loop();
+  /**
+   * Drop all viewers.
+   */
+  void close();
+
+private:
+  WebStream* _viewers[IOTWEBCONF_EVENT_MAX_VIEWERS] = {};
+  // -- Place of the next viewer, when all places are taken.
+  int _nextViewer = 0;
+  unsigned long _lastSent = 0;
+
+  bool write(int i, const char* message, size_t length);
+  void drop(int i);
+};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,428 @@
+/**
+ * IotWebConfJson.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <IotWebConfJson.h>
+
+namespace iotwebconf
+{
+
+JsonWriter::JsonWriter(WebRequestWrapper* webRequestWrapper)
+{
+  this->_webRequestWrapper = webRequestWrapper;
+}
+
+void JsonWriter::beginObject(const char* key)
+{
+  this->writeKey(key);
+  this->_buffer += '{';
+  this->_first = true;
+}
+
+void JsonWriter::endObject()
+{
+  this->_buffer += '}';
+  // -- Parent (if any) now has at least this member.
+  this->_first = false;
+  this->checkFlush();
+}
+
+void JsonWriter::beginArray(const char* key)
+{
+  this->writeKey(key);
+  this->_buffer += '[';
+  this->_first = true;
+}
+
+void JsonWriter::endArray()
+{
+  this->_buffer += ']';
+  this->_first = false;
+  this->checkFlush();
+}
+
+void JsonWriter::writeString(const char* key, const char* value)
+{
+  this->writeKey(key);
+  this->_buffer += '"';
+  this->writeEscaped(value);
+  this->_buffer += '"';
+  this->checkFlush();
+}
+
+void JsonWriter::writeNumber(const char* key, const char* value)
+{
+  this->writeKey(key);
+  bool isNumber = (*value != '\0');
+  for (const char* c = value; *c != '\0'; c++)
+  {
+    if (!isdigit(*c) && (strchr("+-.eE", *c) == NULL))
+    {
+      isNumber = false;
+      break;
+    }
+  }
+  this->_buffer += isNumber ? value : "null";
+  this->checkFlush();
+}
+
+void JsonWriter::writeBool(const char* key, bool value)
+{
+  this->writeKey(key);
+  this->_buffer += value ? "true" : "false";
+  this->checkFlush();
+}
+
+void JsonWriter::flush()
+{
+  if ((this->_webRequestWrapper != NULL) && (this->_buffer.length() > 0))
+  {
+    this->_webRequestWrapper->sendContent(this->_buffer);
+    this->_buffer = "";
+  }
+}
+
+void JsonWriter::writeKey(const char* key)
+{
+  if (!this->_first)
+  {
+    this->_buffer += ',';
+  }
+  this->_first = false;
+  if (key != NULL)
+  {
+    this->_buffer += '"';
+    this->writeEscaped(key);
+    this->_buffer += "\":";
+  }
+}
+
+void JsonWriter::writeEscaped(const char* value)
+{
+  for (const char* c = value; *c != '\0'; c++)
+  {
+    if ((*c == '"') || (*c == '\\'))
+    {
+      this->_buffer += '\\';
+      this->_buffer += *c;
+    }
+    else if ((unsigned char)*c < 0x20)
+    {
+      char escaped[7];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)*c);
+      this->_buffer += escaped;
+    }
+    else
+    {
+      this->_buffer += *c;
+    }
+  }
+}
+
+void JsonWriter::checkFlush()
+{
+  if (this->_buffer.length() >= IOTWEBCONF_JSON_CHUNK_SIZE)
+  {
+    this->flush();
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void skipWhitespace(const char*& p)
+{
+  while ((*p == ' ') || (*p == '\t') || (*p == '\n') || (*p == '\r'))
+  {
+    p++;
+  }
+}
+
+static void appendUtf8(String* out, unsigned long codePoint)
+{
+  if (codePoint < 0x80)
+  {
+    *out += (char)codePoint;
+  }
+  else if (codePoint < 0x800)
+  {
+    *out += (char)(0xC0 | (codePoint >> 6));
+    *out += (char)(0x80 | (codePoint & 0x3F));
+  }
+  else if (codePoint < 0x10000)
+  {
+    *out += (char)(0xE0 | (codePoint >> 12));
+    *out += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+    *out += (char)(0x80 | (codePoint & 0x3F));
+  }
+  else
+  {
+    *out += (char)(0xF0 | (codePoint >> 18));
+    *out += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+    *out += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+    *out += (char)(0x80 | (codePoint & 0x3F));
+  }
+}
+
+static bool parseHex4(const char*& p, unsigned long* value)
+{
+  *value = 0;
+  for (int i = 0; i < 4; i++)
+  {
+    char c = *p++;
+    *value <<= 4;
+    if ((c >= '0') && (c <= '9')) { *value |= c - '0'; }
+    else if ((c >= 'a') && (c <= 'f')) { *value |= c - 'a' + 10; }
+    else if ((c >= 'A') && (c <= 'F')) { *value |= c - 'A' + 10; }
+    else { return false; }
+  }
+  return true;
+}
+
+/**
+ * Parse a JSON string starting at the opening quote. Decoded value is
+ * appended to 'out'.
+ */
+static bool parseString(const char*& p, String* out)
+{
+  if (*p++ != '"')
+  {
+    return false;
+  }
+  while (*p != '"')
+  {
+    char c = *p++;
+    if (c == '\0')
+    {
+      return false;
+    }
+    if (c != '\\')
+    {
+      *out += c;
+      continue;
+    }
+    c = *p++;
+    switch (c)
+    {
+      case '"': case '\\': case '/': *out += c; break;
+      case 'b': *out += '\b'; break;
+      case 'f': *out += '\f'; break;
+      case 'n': *out += '\n'; break;
+      case 'r': *out += '\r'; break;
+      case 't': *out += '\t'; break;
+      case 'u':
+      {
+        unsigned long codePoint;
+        if (!parseHex4(p, &codePoint))
+        {
+          return false;
+        }
+        if ((codePoint >= 0xDC00) && (codePoint < 0xE000))
+        {
+          // -- Low surrogate without a high one.
+          return false;
+        }
+        if ((codePoint >= 0xD800) && (codePoint < 0xDC00))
+        {
+          // -- Surrogate pair, a high surrogate alone has no UTF-8 form.
+          unsigned long low;
+          if ((p[0] != '\\') || (p[1] != 'u'))
+          {
+            return false;
+          }
+          p += 2;
+          if (!parseHex4(p, &low) || (low < 0xDC00) || (low >= 0xE000))
+          {
+            return false;
+          }
+          codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+        }
+        appendUtf8(out, codePoint);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  p++; // -- Closing quote.
+  return true;
+}
+
+static bool skipDigits(const char*& p)
+{
+  if (!isdigit(*p))
+  {
+    return false;
+  }
+  while (isdigit(*p))
+  {
+    p++;
+  }
+  return true;
+}
+
+/**
+ * Parse a JSON number (e.g. -0.5e3), as given by the grammar: no leading
+ * zeros, digits required on both sides of the dot, and in the exponent.
+ */
+static bool parseNumber(const char*& p)
+{
+  if (*p == '-')
+  {
+    p++;
+  }
+  if (*p == '0')
+  {
+    p++;
+  }
+  else if (!skipDigits(p))
+  {
+    return false;
+  }
+  if (*p == '.')
+  {
+    p++;
+    if (!skipDigits(p))
+    {
+      return false;
+    }
+  }
+  if ((*p == 'e') || (*p == 'E'))
+  {
+    p++;
+    if ((*p == '+') || (*p == '-'))
+    {
+      p++;
+    }
+    if (!skipDigits(p))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Parse a JSON value. Only scalar values are supported.
+ */
+static bool parseValue(const char*& p, String* out, bool* present)
+{
+  *present = true;
+  if (*p == '"')
+  {
+    return parseString(p, out);
+  }
+  if (strncmp(p, "true", 4) == 0)
+  {
+    p += 4;
+    *out += "selected";
+    return true;
+  }
+  if (strncmp(p, "false", 5) == 0)
+  {
+    p += 5;
+    *out += "false";
+    *present = false;
+    return true;
+  }
+  if (strncmp(p, "null", 4) == 0)
+  {
+    p += 4;
+    *present = false;
+    return true;
+  }
+  const char* start = p;
+  if (!parseNumber(p))
+  {
+    return false;
+  }
+  out->concat(start, p - start);
+  return true;
+}
+
+JsonRequestWrapper::JsonRequestWrapper(
+  WebRequestWrapper* original, const String& body, bool partial) :
+  IndexedWebRequestWrapper(original, false)
+{
+  this->_body = body;
+  this->_valid = true;
+  this->setPartial(partial);
+  this->_valid = this->forEachMember(
+    [&](const String& key, const String& value, bool present)
+  {
+    if (present)
+    {
+      this->addArg(key.c_str(), key.length(), value.c_str(), value.length());
+    }
+    else if (partial && value.equals("false"))
+    {
+      // -- Missing members are left untouched in a partial request, so
+      //    false is provided as an empty value (unchecked checkbox).
+      this->addArg(key.c_str(), key.length(), "", 0);
+    }
+    return true;
+  });
+  this->buildIndex();
+}
+
+bool JsonRequestWrapper::forEachMember(
+  std::function<bool(const String& key, const String& value, bool present)> callback)
+{
+  if (!this->_valid)
+  {
+    return false;
+  }
+  const char* p = this->_body.c_str();
+  skipWhitespace(p);
+  if (*p++ != '{')
+  {
+    return false;
+  }
+  skipWhitespace(p);
+  if (*p == '}')
+  {
+    return true;
+  }
+  while (true)
+  {
+    String key;
+    String value;
+    bool present;
+    skipWhitespace(p);
+    if (!parseString(p, &key))
+    {
+      return false;
+    }
+    skipWhitespace(p);
+    if (*p++ != ':')
+    {
+      return false;
+    }
+    skipWhitespace(p);
+    if (!parseValue(p, &value, &present))
+    {
+      return false;
+    }
+    if (!callback(key, value, present))
+    {
+      return true;
+    }
+    skipWhitespace(p);
+    if (*p == '}')
+    {
+      return true;
+    }
+    if (*p++ != ',')
+    {
+      return false;
+    }
+  }
+}
+
+} // end namespace
@@ -0,0 +1,106 @@
+/**
+ * IotWebConfJson.h -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfJson_h
+#define IotWebConfJson_h
+
+#include <Arduino.h>
+#include <functional>
+#include <IotWebConfSettings.h>
+#include <IotWebConfWebServerWrapper.h>
+
+namespace iotwebconf
+{
+
+/**
+ * A minimal streaming JSON writer used by the config items to render their
+ * values. When created with a webRequestWrapper, the output is sent to the
+ * client in chunks of IOTWEBCONF_JSON_CHUNK_SIZE bytes, so large
+ * configurations never have to fit into the memory as a whole.
+ * When created without a webRequestWrapper, the whole output is collected
+ * and can be retrieved by getContent().
+ */
+class JsonWriter
+{
+public:
+  JsonWriter(WebRequestWrapper* webRequestWrapper = NULL);
+
+  /**
+   * Start a new object. Key must be NULL for the top level object and for
+   *   array elements. (Same applies for all other write methods.)
+   */
+  void beginObject(const char* key = NULL);
+  void endObject();
+  void beginArray(const char* key = NULL);
+  void endArray();
+
+  void writeString(const char* key, const char* value);
+  /**
+   * Write a number member. The value is the textual representation of
+   *   the number, "null" is written instead of values like "nan".
+   */
+  void writeNumber(const char* key, const char* value);
+  void writeBool(const char* key, bool value);
+
+  /**
+   * Send out buffered content. Must be called after the last write.
+   */
+  void flush();
+  const String& getContent() { return this->_buffer; }
+
+private:
+  WebRequestWrapper* _webRequestWrapper;
+  String _buffer;
+  bool _first = true;
+
+  void writeKey(const char* key);
+  void writeEscaped(const char* value);
+  void checkFlush();
+};
+
+/**
+ * Provides the members of a flat JSON object (posted as request body) as
+ * request arguments, so that the very same validation and update logic
+ * can be used as for the HTML form post.
+ * String and number values are provided as text, "true" is provided as
+ * "selected" (like a checked checkbox), while "false" and "null" members
+ * are handled as if they were not posted at all.
+ * The body is parsed only once, members are looked up from an index.
+ * A partial request provides "false" members as empty values, so that a
+ * checkbox can be unchecked without posting all other values.
+ */
+class JsonRequestWrapper : public IndexedWebRequestWrapper
+{
+public:
+  JsonRequestWrapper(
+    WebRequestWrapper* original, const String& body, bool partial = false);
+
+  /**
+   * Returns false if the body is not a flat JSON object.
+   */
+  bool isValid() { return this->_valid; }
+
+  /**
+   * Iterate through all members of the object. Iteration stops when
+   *   the callback returns false. The "false" and "null" members are
+   *   reported as not present, with value "false" and "" respectively.
+   */
+  bool forEachMember(
+    std::function<bool(const String& key, const String& value, bool present)> callback);
+
+private:
+  String _body;
+  bool _valid;
+};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,165 @@
+/**
+ * IotWebConfLoopTask.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <IotWebConfLoopTask.h>
+
+namespace iotwebconf
+{
+
+LoopTask::LoopTask(
+  const char* id, std::function<void(unsigned long budgetMicros)> func,
+  unsigned long budgetMicros)
+{
+  this->_id = id;
+  this->_func = func;
+  this->budgetMicros = budgetMicros;
+}
+
+void LoopTask::run(unsigned long budgetMicros)
+{
+  this->_worked = false;
+  unsigned long start = micros();
+  this->_func(budgetMicros);
+  unsigned long duration = micros() - start;
+
+  this->_lastMicros = duration;
+  if (this->_maxMicros < duration)
+  {
+    this->_maxMicros = duration;
+  }
+  this->_totalMicros += duration;
+  this->_runCount++;
+  if (duration > budgetMicros)
+  {
+    this->_overrunCount++;
+  }
+}
+
+void LoopTask::resetStatistics()
+{
+  this->_lastMicros = 0;
+  this->_maxMicros = 0;
+  this->_totalMicros = 0;
+  this->_runCount = 0;
+  this->_overrunCount = 0;
+  this->_skipCount = 0;
+}
+
+void LoopTask::debugTo(Stream* out)
+{
+  out->print(this->_id);
+  out->print(F(": runs "));
+  out->print(this->_runCount);
+  out->print(F(", total "));
+  out->print(this->_totalMicros);
+  out->print(F("us, max "));
+  out->print(this->_maxMicros);
+  out->print(F("us, overruns "));
+  out->print(this->_overrunCount);
+  out->print(F(", skipped "));
+  out->println(this->_skipCount);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void LoopScheduler::addTask(LoopTask* task)
+{
+  if (this->_firstTask == NULL)
+  {
+    this->_firstTask = task;
+    this->_nextTask = task;
+    this->_nextNestedTask = task;
+  }
+  else
+  {
+    LoopTask* current = this->_firstTask;
+    while (current->_nextTask != NULL)
+    {
+      current = current->_nextTask;
+    }
+    current->_nextTask = task;
+  }
+}
+
+bool LoopScheduler::runPass(unsigned long loopBudgetMicros)
+{
+  return this->runPass(loopBudgetMicros, NULL, &this->_nextTask);
+}
+
+bool LoopScheduler::runNestedPass(
+  unsigned long loopBudgetMicros, LoopTask* except)
+{
+  return this->runPass(loopBudgetMicros, except, &this->_nextNestedTask);
+}
+
+bool LoopScheduler::runPass(
+  unsigned long loopBudgetMicros, LoopTask* except, LoopTask** cursor)
+{
+  if (this->_firstTask == NULL)
+  {
+    return false;
+  }
+  bool busy = false;
+  unsigned long passStart = micros();
+  LoopTask* passFirst = *cursor;
+  LoopTask* task = passFirst;
+  do
+  {
+    if ((task == except) || task->suspended)
+    {
+      task = this->next(task);
+      continue;
+    }
+    unsigned long elapsed = micros() - passStart;
+    if ((task != passFirst) && (elapsed >= loopBudgetMicros))
+    {
+      // -- Time is up, the rest is started with in the next pass.
+      *cursor = task;
+      do
+      {
+        if ((task != except) && !task->suspended)
+        {
+          task->_skipCount++;
+        }
+        task = this->next(task);
+      } while (task != passFirst);
+      return true;
+    }
+
+    unsigned long remaining =
+      elapsed < loopBudgetMicros ? loopBudgetMicros - elapsed : 0;
+    task->run(
+      task->budgetMicros < remaining ? task->budgetMicros : remaining);
+    if (task->_worked)
+    {
+      busy = true;
+    }
+    task = this->next(task);
+  } while (task != passFirst);
+  return busy;
+}
+
+LoopTask* LoopScheduler::next(LoopTask* task)
+{
+  return task->_nextTask == NULL ? this->_firstTask : task->_nextTask;
+}
+
+void LoopScheduler::debugTo(Stream* out)
+{
+  LoopTask* current = this->_firstTask;
+  while (current != NULL)
+  {
+    current->debugTo(out);
+    current = current->_nextTask;
+  }
+}
+
+} // end namespace
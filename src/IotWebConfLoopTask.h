@@ -0,0 +1,133 @@
+/**
+ * IotWebConfLoopTask.h -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfLoopTask_h
+#define IotWebConfLoopTask_h
+
+#include <Arduino.h>
+#include <functional>
+#include <IotWebConfSettings.h>
+
+namespace iotwebconf
+{
+
+class LoopScheduler;
+
+/**
+ * A piece of work done in doLoop(). The task function receives the time
+ * (in microseconds) it may spend, and should return in time. Tasks are not
+ * interrupted, so a task running longer than its budget delays all the
+ * others (this is counted as an overrun).
+ * Statistics of the task are collected, so that you can find out, which
+ * task is consuming the time of the loop.
+ */
+class LoopTask
+{
+public:
+  LoopTask(
+    const char* id, std::function<void(unsigned long budgetMicros)> func,
+    unsigned long budgetMicros);
+
+  const char* getId() { return this->_id; }
+
+  /**
+   * Time the task may spend in one run, in microseconds.
+   */
+  unsigned long budgetMicros;
+  /**
+   * A suspended task is left out of the loop passes (without counting it
+   * as skipped), until it is resumed by clearing this flag.
+   */
+  bool suspended = false;
+
+  /**
+   * Call this from the task function, when the task had work to do (e.g.
+   *   served a request). After a pass where no task reported work,
+   *   IotWebConf::delay() sleeps instead of running the next pass right
+   *   away.
+   */
+  void reportWork() { this->_worked = true; }
+  /**
+   * Whether the task reported work in its last run.
+   */
+  bool hasWorked() { return this->_worked; }
+
+  unsigned long getLastMicros() { return this->_lastMicros; }
+  unsigned long getMaxMicros() { return this->_maxMicros; }
+  unsigned long getTotalMicros() { return this->_totalMicros; }
+  unsigned long getRunCount() { return this->_runCount; }
+  /**
+   * Count of runs longer than the budget.
+   */
+  unsigned long getOverrunCount() { return this->_overrunCount; }
+  /**
+   * Count of loop passes, where the task was not run, as the time of the
+   * pass was already used up by other tasks.
+   */
+  unsigned long getSkipCount() { return this->_skipCount; }
+  void resetStatistics();
+
+  void debugTo(Stream* out);
+
+private:
+  const char* _id;
+  std::function<void(unsigned long budgetMicros)> _func;
+  unsigned long _lastMicros = 0;
+  unsigned long _maxMicros = 0;
+  unsigned long _totalMicros = 0;
+  unsigned long _runCount = 0;
+  unsigned long _overrunCount = 0;
+  unsigned long _skipCount = 0;
+  bool _worked = false;
+  LoopTask* _nextTask = NULL;
+
+  void run(unsigned long budgetMicros);
+  friend class LoopScheduler; // Allow scheduler to access _nextTask.
+};
+
+/**
+ * Runs the tasks one after the other, until the time of the loop pass is
+ * used up. Tasks left out are run first in the next pass, so every task is
+ * run at least in every n-th pass (where n is the number of tasks), even
+ * when the others always use up the time. A pass is thus at most as long as
+ * the loop budget plus the overrun of the last task.
+ */
+class LoopScheduler
+{
+public:
+  void addTask(LoopTask* task);
+  /**
+   * Run the tasks for at most the time given. Returns false, if none of the
+   *   tasks reported work (see LoopTask::reportWork()), and all of them
+   *   were run.
+   */
+  bool runPass(unsigned long loopBudgetMicros);
+  /**
+   * A pass run from within a task (e.g. while a long page is being
+   *   rendered), leaving out that 'except' task. It keeps a round robin
+   *   position of its own, so the order of the outer passes is not changed.
+   */
+  bool runNestedPass(unsigned long loopBudgetMicros, LoopTask* except);
+  void debugTo(Stream* out);
+
+private:
+  LoopTask* _firstTask = NULL;
+  LoopTask* _nextTask = NULL;
+  LoopTask* _nextNestedTask = NULL;
+
+  bool runPass(
+    unsigned long loopBudgetMicros, LoopTask* except, LoopTask** cursor);
+  LoopTask* next(LoopTask* task);
+};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,731 @@
+/**
+ * IotWebConfNumber.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <IotWebConfNumber.h>
+#include <math.h>
+
+namespace iotwebconf
+{
+
+// -- Powers of ten exactly representable by a double.
+static const double exactPowers[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+static const int maxExactPower = 22;
+// -- Largest integer a double holds exactly (2^53).
+static const uint64_t maxExactMantissa = 9007199254740992ULL;
+
+static void skipSpaces(const char** text, size_t* length)
+{
+  while ((*length > 0) && (**text == ' '))
+  {
+    (*text)++;
+    (*length)--;
+  }
+  while ((*length > 0) && ((*text)[*length - 1] == ' '))
+  {
+    (*length)--;
+  }
+}
+
+static int digitValue(char c)
+{
+  if ((c >= '0') && (c <= '9'))
+  {
+    return c - '0';
+  }
+  if ((c >= 'a') && (c <= 'z'))
+  {
+    return c - 'a' + 10;
+  }
+  if ((c >= 'A') && (c <= 'Z'))
+  {
+    return c - 'A' + 10;
+  }
+  return 99;
+}
+
+/**
+ * All of the text must be digits, and at least one.
+ */
+static bool parseDigits(
+  const char* text, size_t length, uint64_t max, uint64_t* value, int base)
+{
+  if ((length == 0) || (base < 2) || (base > 36))
+  {
+    return false;
+  }
+  // -- Overflow is checked without dividing for each digit.
+  uint64_t limit = max / base;
+  int lastDigit = max % base;
+  uint64_t result = 0;
+  for (size_t i = 0; i < length; i++)
+  {
+    int digit = digitValue(text[i]);
+    if ((digit >= base)
+      || (result > limit) || ((result == limit) && (digit > lastDigit)))
+    {
+      return false;
+    }
+    result = result * base + digit;
+  }
+  *value = result;
+  return true;
+}
+
+static void skipHexPrefix(const char** text, size_t* length, int base)
+{
+  if ((base == 16) && (*length > 2)
+    && ((*text)[0] == '0') && (((*text)[1] == 'x') || ((*text)[1] == 'X')))
+  {
+    *text += 2;
+    *length -= 2;
+  }
+}
+
+bool parseSigned(
+  const char* text, size_t length, int64_t min, int64_t max,
+  int64_t* value, int base)
+{
+  skipSpaces(&text, &length);
+  bool negative = (length > 0) && (*text == '-');
+  if ((length > 0) && ((*text == '-') || (*text == '+')))
+  {
+    text++;
+    length--;
+  }
+  skipHexPrefix(&text, &length, base);
+
+  uint64_t magnitude;
+  if (negative)
+  {
+    if ((min >= 0)
+      || !parseDigits(text, length, (uint64_t)(-(min + 1)) + 1, &magnitude, base))
+    {
+      return false;
+    }
+    *value = (magnitude == 0) ? 0 : -(int64_t)(magnitude - 1) - 1;
+  }
+  else
+  {
+    if ((max < 0) || !parseDigits(text, length, (uint64_t)max, &magnitude, base))
+    {
+      return false;
+    }
+    *value = (int64_t)magnitude;
+  }
+  return true;
+}
+
+bool parseUnsigned(
+  const char* text, size_t length, uint64_t max, uint64_t* value, int base)
+{
+  skipSpaces(&text, &length);
+  if ((length > 0) && (*text == '+'))
+  {
+    text++;
+    length--;
+  }
+  skipHexPrefix(&text, &length, base);
+  return parseDigits(text, length, max, value, base);
+}
+
+/**
+ * Decimal number split into an integer mantissa (first 19 significant
+ * digits) and a power of ten.
+ */
+struct DecimalNumber
+{
+  bool negative = false;
+  uint64_t mantissa = 0;
+  int exponent = 0;
+  bool truncated = false;
+};
+
+static bool parseDecimal(const char* text, size_t length, DecimalNumber* number)
+{
+  const char* end = text + length;
+  if ((text < end) && ((*text == '-') || (*text == '+')))
+  {
+    number->negative = (*text == '-');
+    text++;
+  }
+
+  int digitCount = 0;
+  int significantDigits = 0;
+  bool fraction = false;
+  for (; text < end; text++)
+  {
+    if ((*text == '.') && !fraction)
+    {
+      fraction = true;
+      continue;
+    }
+    if ((*text < '0') || (*text > '9'))
+    {
+      break;
+    }
+    digitCount++;
+    if ((significantDigits == 0) && (*text == '0'))
+    {
+      // -- Leading zeros only move the decimal point.
+      number->exponent -= fraction ? 1 : 0;
+    }
+    else if (significantDigits < 19)
+    {
+      number->mantissa = number->mantissa * 10 + (*text - '0');
+      number->exponent -= fraction ? 1 : 0;
+      significantDigits++;
+    }
+    else
+    {
+      number->exponent += fraction ? 0 : 1;
+      number->truncated |= (*text != '0');
+    }
+  }
+  if (digitCount == 0)
+  {
+    return false;
+  }
+
+  if ((text < end) && ((*text == 'e') || (*text == 'E')))
+  {
+    text++;
+    bool negativeExponent = (text < end) && (*text == '-');
+    if ((text < end) && ((*text == '-') || (*text == '+')))
+    {
+      text++;
+    }
+    if (text == end)
+    {
+      return false;
+    }
+    int exponent = 0;
+    for (; (text < end) && (*text >= '0') && (*text <= '9'); text++)
+    {
+      // -- Anything above this is zero or infinite anyway.
+      if (exponent < 10000)
+      {
+        exponent = exponent * 10 + (*text - '0');
+      }
+    }
+    number->exponent += negativeExponent ? -exponent : exponent;
+  }
+  return text == end;
+}
+
+/**
+ * With an exact mantissa and an exact power of ten, a single multiplication
+ * or division gives the correctly rounded double. Returns false when that
+ * is not the case.
+ */
+static bool exactDecimal(uint64_t mantissa, int exponent, double* value)
+{
+  if ((mantissa > maxExactMantissa)
+    || (exponent < -maxExactPower) || (exponent > maxExactPower))
+  {
+    return false;
+  }
+  *value = exponent < 0
+    ? (double)mantissa / exactPowers[-exponent]
+    : (double)mantissa * exactPowers[exponent];
+  return true;
+}
+
+/**
+ * The float nearest to an exact decimal, given the double nearest to it
+ * (see exactDecimal()). Rounding that double again is wrong, when it lies
+ * right halfway between two floats, but the decimal does not: the side of
+ * the decimal is told then by the sign of the error of the double, that
+ * fma() computes with a single rounding.
+ */
+static float nearestFloat(uint64_t mantissa, int exponent, double nearest)
+{
+  float result = (float)nearest;
+  if ((double)result == nearest)
+  {
+    return result;
+  }
+  float other = nextafterf(result, nearest > result ? INFINITY : 0);
+  if (nearest != ((double)result + (double)other) / 2)
+  {
+    return result;
+  }
+  double error = exponent < 0
+    ? fma(-nearest, exactPowers[-exponent], (double)mantissa)
+    : fma((double)mantissa, exactPowers[exponent], -nearest);
+  if (error == 0)
+  {
+    // -- A real tie, rounded to even.
+    return result;
+  }
+  return (error > 0) == (other > result) ? other : result;
+}
+
+/**
+ * Numbers not having an exact decimal form are left to the C library, the
+ * text has to be zero terminated then.
+ */
+static bool terminate(const char* text, size_t length, char* terminated)
+{
+  if (length >= IOTWEBCONF_NUMBER_TEXT_SIZE)
+  {
+    return false;
+  }
+  memcpy(terminated, text, length);
+  terminated[length] = '\0';
+  return true;
+}
+
+bool parseFloat(const char* text, size_t length, float* value)
+{
+  skipSpaces(&text, &length);
+  DecimalNumber number;
+  if (!parseDecimal(text, length, &number))
+  {
+    return false;
+  }
+
+  float result;
+  double nearest;
+  char terminated[IOTWEBCONF_NUMBER_TEXT_SIZE];
+  if (number.mantissa == 0)
+  {
+    result = 0;
+  }
+  else if (!number.truncated
+    && exactDecimal(number.mantissa, number.exponent, &nearest))
+  {
+    result = nearestFloat(number.mantissa, number.exponent, nearest);
+  }
+  else if (terminate(text, length, terminated))
+  {
+    // -- Values slightly above FLT_MAX still round to it.
+    result = fabsf(strtof(terminated, NULL));
+  }
+  else
+  {
+    return false;
+  }
+  if (isinf(result))
+  {
+    return false;
+  }
+  *value = number.negative ? -result : result;
+  return true;
+}
+
+bool parseDouble(const char* text, size_t length, double* value)
+{
+  skipSpaces(&text, &length);
+  DecimalNumber number;
+  if (!parseDecimal(text, length, &number))
+  {
+    return false;
+  }
+
+  double result;
+  char terminated[IOTWEBCONF_NUMBER_TEXT_SIZE];
+  if (number.mantissa == 0)
+  {
+    result = 0;
+  }
+  else if (!number.truncated
+    && exactDecimal(number.mantissa, number.exponent, &result))
+  {
+  }
+  else if (terminate(text, length, terminated))
+  {
+    result = fabs(strtod(terminated, NULL));
+  }
+  else
+  {
+    return false;
+  }
+  if (isinf(result))
+  {
+    return false;
+  }
+  *value = number.negative ? -result : result;
+  return true;
+}
+
+bool parseBool(const char* text, size_t length, bool* value)
+{
+  skipSpaces(&text, &length);
+  if (((length == 1) && (*text == '1'))
+    || ((length == 4) && (strncmp(text, "true", 4) == 0))
+    || ((length == 8) && (strncmp(text, "selected", 8) == 0)))
+  {
+    *value = true;
+    return true;
+  }
+  if (((length == 1) && (*text == '0'))
+    || ((length == 5) && (strncmp(text, "false", 5) == 0)))
+  {
+    *value = false;
+    return true;
+  }
+  return false;
+}
+
+bool parseIp(const char* text, size_t length, IPAddress* value)
+{
+  skipSpaces(&text, &length);
+  const char* end = text + length;
+  uint8_t bytes[4];
+  for (int i = 0; i < 4; i++)
+  {
+    if ((i > 0) && ((text == end) || (*text++ != '.')))
+    {
+      return false;
+    }
+    unsigned int byte = 0;
+    int digits = 0;
+    for (; (text < end) && (*text >= '0') && (*text <= '9'); text++)
+    {
+      byte = byte * 10 + (*text - '0');
+      digits++;
+    }
+    if ((digits == 0) || (digits > 3) || (byte > 255))
+    {
+      return false;
+    }
+    bytes[i] = (uint8_t)byte;
+  }
+  if (text != end)
+  {
+    return false;
+  }
+  *value = IPAddress(bytes[0], bytes[1], bytes[2], bytes[3]);
+  return true;
+}
+
+bool parseHex(const char* text, size_t length, int digits, uint64_t* value)
+{
+  if ((digits < 1) || (digits > 16) || (length != (size_t)digits))
+  {
+    return false;
+  }
+  return parseDigits(text, length, UINT64_MAX, value, 16);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t formatFailed(char* buffer, size_t size)
+{
+  if (size > 0)
+  {
+    buffer[0] = '\0';
+  }
+  return 0;
+}
+
+static size_t copyText(const char* text, size_t length, char* buffer, size_t size)
+{
+  if (length + 1 > size)
+  {
+    return formatFailed(buffer, size);
+  }
+  memcpy(buffer, text, length);
+  buffer[length] = '\0';
+  return length;
+}
+
+/**
+ * Digits are written backwards, ending at 'end'. Returns the first one.
+ */
+static char* writeDigits(uint64_t value, char* end, int base)
+{
+  if (base == 10)
+  {
+    // -- Division by a constant is a multiplication, and 32 bit arithmetic
+    // is much cheaper on the ESP.
+    while (value > UINT32_MAX)
+    {
+      *--end = '0' + value % 10;
+      value /= 10;
+    }
+    uint32_t small = (uint32_t)value;
+    do
+    {
+      *--end = '0' + small % 10;
+      small /= 10;
+    } while (small > 0);
+    return end;
+  }
+  do
+  {
+    int digit = value % base;
+    *--end = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    value /= base;
+  } while (value > 0);
+  return end;
+}
+
+size_t formatUnsigned(uint64_t value, char* buffer, size_t size, int base)
+{
+  if ((base < 2) || (base > 36))
+  {
+    return formatFailed(buffer, size);
+  }
+  char text[IOTWEBCONF_NUMBER_TEXT_SIZE];
+  char* end = text + sizeof(text);
+  char* begin = writeDigits(value, end, base);
+  return copyText(begin, end - begin, buffer, size);
+}
+
+size_t formatSigned(int64_t value, char* buffer, size_t size, int base)
+{
+  if ((base < 2) || (base > 36))
+  {
+    return formatFailed(buffer, size);
+  }
+  char text[IOTWEBCONF_NUMBER_TEXT_SIZE];
+  char* end = text + sizeof(text);
+  char* begin = writeDigits(
+    value < 0 ? 0 - (uint64_t)value : (uint64_t)value, end, base);
+  if (value < 0)
+  {
+    *--begin = '-';
+  }
+  return copyText(begin, end - begin, buffer, size);
+}
+
+/**
+ * Power of ten for producing digits. Not exact beyond 1e22, but the result
+ * is checked by parsing it back anyway.
+ */
+static double powerOfTen(int exponent)
+{
+  double result = 1;
+  int left = exponent < 0 ? -exponent : exponent;
+  while (left > maxExactPower)
+  {
+    result *= exactPowers[maxExactPower];
+    left -= maxExactPower;
+  }
+  result *= exactPowers[left];
+  return exponent < 0 ? 1 / result : result;
+}
+
+/**
+ * Text of digits[0..count) * 10^(exponent - count + 1), i.e. exponent is
+ * the power of ten of the first digit.
+ */
+static size_t writeDecimal(
+  bool negative, const char* digits, int count, int exponent,
+  char* text, size_t size)
+{
+  // -- Trailing zeros are not written.
+  while ((count > 1) && (digits[count - 1] == '0'))
+  {
+    count--;
+  }
+
+  char* p = text;
+  if (negative)
+  {
+    *p++ = '-';
+  }
+  if ((exponent < -5) || (exponent >= 9))
+  {
+    *p++ = digits[0];
+    if (count > 1)
+    {
+      *p++ = '.';
+      memcpy(p, digits + 1, count - 1);
+      p += count - 1;
+    }
+    *p++ = 'e';
+    char* end = text + size;
+    char* begin = writeDigits(exponent < 0 ? -exponent : exponent, end, 10);
+    if (exponent < 0)
+    {
+      *p++ = '-';
+    }
+    memmove(p, begin, end - begin);
+    p += end - begin;
+  }
+  else if (exponent < 0)
+  {
+    *p++ = '0';
+    *p++ = '.';
+    for (int i = -1; i > exponent; i--)
+    {
+      *p++ = '0';
+    }
+    memcpy(p, digits, count);
+    p += count;
+  }
+  else
+  {
+    for (int i = 0; i < count; i++)
+    {
+      if (i == exponent + 1)
+      {
+        *p++ = '.';
+      }
+      *p++ = digits[i];
+    }
+    for (int i = count; i <= exponent; i++)
+    {
+      *p++ = '0';
+    }
+  }
+  *p = '\0';
+  return p - text;
+}
+
+static size_t formatNotFinite(double value, char* buffer, size_t size)
+{
+  if (isnan(value))
+  {
+    return copyText("nan", 3, buffer, size);
+  }
+  return value < 0
+    ? copyText("-inf", 4, buffer, size) : copyText("inf", 3, buffer, size);
+}
+
+/**
+ * The digits of a float fit well into the precision of a double, so they are
+ * produced by scaling with a power of ten. Count of digits is increased until
+ * the digits give back the same float, computed the same way as parseFloat()
+ * does. (The text itself is parsed back only when that is not exact.)
+ */
+size_t formatFloat(float value, char* buffer, size_t size)
+{
+  if (!isfinite(value))
+  {
+    return formatNotFinite(value, buffer, size);
+  }
+  char text[32];
+  if (value == 0)
+  {
+    return copyText(text, writeDecimal(signbit(value), "0", 1, 0, text, sizeof(text)),
+      buffer, size);
+  }
+
+  double magnitude = fabs((double)value);
+  int exponent = (int)floor(log10(magnitude));
+  // -- Between 1 and 10 (log10() might be a bit off at the edges).
+  double normalized = magnitude * powerOfTen(-exponent);
+  if (normalized >= 10)
+  {
+    normalized /= 10;
+    exponent++;
+  }
+  else if (normalized < 1)
+  {
+    normalized *= 10;
+    exponent--;
+  }
+
+  uint64_t scaled = 0;
+  int firstExponent = exponent;
+  char digits[24];
+  char* end = digits + sizeof(digits);
+  for (int count = 1; count <= 9; count++)
+  {
+    scaled = (uint64_t)llround(normalized * exactPowers[count - 1]);
+    firstExponent = exponent;
+    if (scaled >= (uint64_t)exactPowers[count])
+    {
+      // -- Rounded up to one more digit (e.g. 9.99 to 10.0).
+      scaled /= 10;
+      firstExponent++;
+    }
+    double exact;
+    if (exactDecimal(scaled, firstExponent - count + 1, &exact))
+    {
+      if (nearestFloat(scaled, firstExponent - count + 1, exact) == magnitude)
+      {
+        break;
+      }
+      continue;
+    }
+    char* begin = writeDigits(scaled, end, 10);
+    size_t length = writeDecimal(
+      false, begin, end - begin, firstExponent, text, sizeof(text));
+    float parsed;
+    if (parseFloat(text, length, &parsed) && (parsed == magnitude))
+    {
+      break;
+    }
+  }
+  char* begin = writeDigits(scaled, end, 10);
+  size_t length = writeDecimal(
+    value < 0, begin, end - begin, firstExponent, text, sizeof(text));
+  return copyText(text, length, buffer, size);
+}
+
+size_t formatDouble(double value, char* buffer, size_t size)
+{
+  if (!isfinite(value))
+  {
+    return formatNotFinite(value, buffer, size);
+  }
+  char text[32];
+  int length = 0;
+  for (int precision = 15; precision <= 17; precision++)
+  {
+    length = snprintf(text, sizeof(text), "%.*g", precision, value);
+    double parsed;
+    if (parseDouble(text, length, &parsed) && (parsed == value))
+    {
+      break;
+    }
+  }
+  return copyText(text, length, buffer, size);
+}
+
+size_t formatBool(bool value, char* buffer, size_t size)
+{
+  return copyText(value ? "1" : "0", 1, buffer, size);
+}
+
+size_t formatIp(const IPAddress& value, char* buffer, size_t size)
+{
+  char text[16];
+  char* p = text;
+  for (int i = 0; i < 4; i++)
+  {
+    if (i > 0)
+    {
+      *p++ = '.';
+    }
+    char digits[3];
+    char* end = digits + sizeof(digits);
+    char* begin = writeDigits(value[i], end, 10);
+    memcpy(p, begin, end - begin);
+    p += end - begin;
+  }
+  return copyText(text, p - text, buffer, size);
+}
+
+size_t formatHex(uint64_t value, int digits, char* buffer, size_t size)
+{
+  if ((digits < 1) || (digits > 16)
+    || ((digits < 16) && (value >> (4 * digits) != 0)))
+  {
+    return formatFailed(buffer, size);
+  }
+  char text[16];
+  char* end = text + digits;
+  char* begin = writeDigits(value, end, 16);
+  while (begin > text)
+  {
+    *--begin = '0';
+  }
+  return copyText(text, digits, buffer, size);
+}
+
+} // end namespace
@@ -0,0 +1,165 @@
+/**
+ * IotWebConfNumber.h -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfNumber_h
+#define IotWebConfNumber_h
+
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <limits>
+#include <type_traits>
+
+// -- Buffer size (with the terminating zero) taking the text of any value
+// formatted by these routines, even a 64 bit number in base 2.
+#define IOTWEBCONF_NUMBER_TEXT_SIZE 66
+
+namespace iotwebconf
+{
+
+/**
+ * Parsing and formatting of the values of the typed parameters, in the
+ * manner of <charconv>: nothing is allocated, text is parsed from a pointer
+ * and a length (not necessarily zero terminated), and formatted into a buffer
+ * of the caller.
+ *
+ * Parse functions accept the whole text only (surrounding spaces aside), and
+ *   return false for anything else, or for a value out of the range of the
+ *   type. The value is not touched then.
+ * Format functions write a zero terminated text, and return its length, or 0
+ *   if the buffer was too small (the buffer holds an empty text then).
+ *   Formatted text is always parsed back to the very same value.
+ */
+
+/**
+ * @base - 2 to 36. With base 16 a "0x" prefix is accepted.
+ */
+bool parseSigned(
+  const char* text, size_t length, int64_t min, int64_t max,
+  int64_t* value, int base = 10);
+bool parseUnsigned(
+  const char* text, size_t length, uint64_t max,
+  uint64_t* value, int base = 10);
+/**
+ * Floats are parsed without the C library when the text has at most 19
+ *   significant digits and the decimal exponent is small, which is the case
+ *   for any sensible config value. Others fall back to strtod(), or
+ *   strtof() for floats. So a float is rounded from the decimal once, not
+ *   through a double, unless strtof() of the core does that (e.g. newlib).
+ */
+bool parseFloat(const char* text, size_t length, float* value);
+bool parseDouble(const char* text, size_t length, double* value);
+/**
+ * Accepts "1", "true" and "selected" (the value of a checked checkbox), or
+ *   "0" and "false".
+ */
+bool parseBool(const char* text, size_t length, bool* value);
+/**
+ * Dotted decimal IPv4 address, e.g. "192.168.4.1".
+ */
+bool parseIp(const char* text, size_t length, IPAddress* value);
+/**
+ * Exactly 'digits' hex digits (e.g. a MAC address part, or an ID of fixed
+ *   width), in any case.
+ */
+bool parseHex(const char* text, size_t length, int digits, uint64_t* value);
+
+/**
+ * Digits above 9 are lower case letters.
+ */
+size_t formatSigned(int64_t value, char* buffer, size_t size, int base = 10);
+size_t formatUnsigned(uint64_t value, char* buffer, size_t size, int base = 10);
+/**
+ * The shortest text parsed back to the same value, so 0.1f is "0.1" (not
+ *   "0.10" or "0.100000001"). Exponent is used below 1e-5 and from 1e9 on,
+ *   e.g. "1.5e-7". Not finite values are "nan", "inf" and "-inf".
+ *   Doubles are formatted by snprintf() (still into the buffer), as the
+ *   digits of a double do not fit into the integer arithmetic used for
+ *   floats.
+ */
+size_t formatFloat(float value, char* buffer, size_t size);
+size_t formatDouble(double value, char* buffer, size_t size);
+/**
+ * "1" or "0".
+ */
+size_t formatBool(bool value, char* buffer, size_t size);
+size_t formatIp(const IPAddress& value, char* buffer, size_t size);
+/**
+ * Zero padded, lower case hex of exactly 'digits' digits (at most 16).
+ *   Returns 0 for a value not fitting into the digits.
+ */
+size_t formatHex(uint64_t value, int digits, char* buffer, size_t size);
+
+/**
+ * Parse/format of any primitive type, as used by the typed parameters.
+ *   Integers are checked for the range of their own type.
+ */
+template <typename ValueType>
+bool parseNumber(const char* text, size_t length, ValueType* value, int base = 10)
+{
+  if (std::is_signed<ValueType>::value)
+  {
+    int64_t parsed;
+    if (!parseSigned(text, length,
+      (int64_t)std::numeric_limits<ValueType>::min(),
+      (int64_t)std::numeric_limits<ValueType>::max(), &parsed, base))
+    {
+      return false;
+    }
+    *value = (ValueType)parsed;
+  }
+  else
+  {
+    uint64_t parsed;
+    if (!parseUnsigned(text, length,
+      (uint64_t)std::numeric_limits<ValueType>::max(), &parsed, base))
+    {
+      return false;
+    }
+    *value = (ValueType)parsed;
+  }
+  return true;
+}
+inline bool parseNumber(const char* text, size_t length, float* value, int base = 10)
+{
+  return parseFloat(text, length, value);
+}
+inline bool parseNumber(const char* text, size_t length, double* value, int base = 10)
+{
+  return parseDouble(text, length, value);
+}
+inline bool parseNumber(const char* text, size_t length, bool* value, int base = 10)
+{
+  return parseBool(text, length, value);
+}
+
+template <typename ValueType>
+size_t formatNumber(ValueType value, char* buffer, size_t size, int base = 10)
+{
+  return std::is_signed<ValueType>::value
+    ? formatSigned((int64_t)value, buffer, size, base)
+    : formatUnsigned((uint64_t)value, buffer, size, base);
+}
+inline size_t formatNumber(float value, char* buffer, size_t size, int base = 10)
+{
+  return formatFloat(value, buffer, size);
+}
+inline size_t formatNumber(double value, char* buffer, size_t size, int base = 10)
+{
+  return formatDouble(value, buffer, size);
+}
+inline size_t formatNumber(bool value, char* buffer, size_t size, int base = 10)
+{
+  return formatBool(value, buffer, size);
+}
+
+} // end namespace
+
+#endif
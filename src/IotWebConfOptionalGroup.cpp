@@ -61,8 +61,21 @@ void OptionalParameterGroup::loadValue(
   ParameterGroup::loadValue(doLoad);
 }
 
-void OptionalParameterGroup::renderHtml(
+bool OptionalParameterGroup::renderHtmlBegin(
   bool dataArrived, WebRequestWrapper* webRequestWrapper)
+{
+#ifdef IOTWEBCONF_CONFIG_RENDER_INACTIVE_GROUPS_LAZY
+  // -- Fields of an inactive group are fetched by showFs() on activation.
+  if (!this->_active && this->renderLazyHtml(dataArrived, webRequestWrapper))
+  {
+    return false;
+  }
+#endif
+  return ParameterGroup::renderHtmlBegin(dataArrived, webRequestWrapper);
+}
+
+void OptionalParameterGroup::renderHtmlStart(
+  WebRequestWrapper* webRequestWrapper)
 {
     if (this->label != NULL)
     {
@@ -82,22 +95,6 @@ void OptionalParameterGroup::renderHtml(
       }
       webRequestWrapper->sendContent(content);
     }
-    ConfigItem* current = this->_firstItem;
-    while (current != NULL)
-    {
-      if (current->visible)
-      {
-        current->renderHtml(dataArrived, webRequestWrapper);
-      }
-      current = this->getNextItemOf(current);
-    }
-    if (this->label != NULL)
-    {
-      String content = getEndTemplate();
-      content.replace("{b}", this->label);
-      content.replace("{i}", this->getId());
-      webRequestWrapper->sendContent(content);
-    }
 }
 
 void OptionalParameterGroup::update(WebRequestWrapper* webRequestWrapper)
@@ -108,13 +105,66 @@ void OptionalParameterGroup::update(WebRequestWrapper* webRequestWrapper)
   if (webRequestWrapper->hasArg(activeId))
   {
     String activeStr = webRequestWrapper->arg(activeId);
-    this->_active = activeStr.equals("active");
+    bool active = activeStr.equals("active");
+    if (active != this->_active)
+    {
+      this->_active = active;
+      this->markChanged();
+    }
+    if (!active)
+    {
+      // -- Fields of a group posted as inactive were not validated (see
+      //    validate()), so their values are not stored either.
+      this->clearChanged();
+      return;
+    }
   }
 
   // Update other items.
   ParameterGroup::update(webRequestWrapper);
 }
 
+bool OptionalParameterGroup::validate(WebRequestWrapper* webRequestWrapper)
+{
+  // -- Fields of a group posted as inactive are hidden for the user, so
+  //    errors could not be fixed there.
+  String activeId = String(this->getId());
+  activeId += 'v';
+  if (webRequestWrapper->hasArg(activeId)
+    && !webRequestWrapper->arg(activeId).equals("active"))
+  {
+    return true;
+  }
+  return ParameterGroup::validate(webRequestWrapper);
+}
+
+void OptionalParameterGroup::renderJson(JsonWriter* jsonWriter)
+{
+  // -- Active flag uses the same key as the form field.
+  String activeId = String(this->getId());
+  activeId += 'v';
+  jsonWriter->writeString(activeId.c_str(), this->_active ? "active" : "inactive");
+
+  // -- Render other items.
+  ParameterGroup::renderJson(jsonWriter);
+}
+
+void OptionalParameterGroup::renderChangedJson(JsonWriter* jsonWriter)
+{
+  if (this->isChanged())
+  {
+    String activeId = String(this->getId());
+    activeId += 'v';
+    jsonWriter->writeString(activeId.c_str(), this->_active ? "active" : "inactive");
+  }
+  ParameterGroup::renderChangedJson(jsonWriter);
+}
+
+void OptionalParameterGroup::renderJsonSchemaAttributes(JsonWriter* jsonWriter)
+{
+  jsonWriter->writeBool("a", this->_active);
+}
+
 void OptionalParameterGroup::debugTo(Stream* out)
 {
   out->print('(');
@@ -154,5 +204,13 @@ String ChainedParameterGroup::getEndTemplate()
   return result;
 };
 
+void ChainedParameterGroup::renderJsonSchemaAttributes(JsonWriter* jsonWriter)
+{
+  OptionalParameterGroup::renderJsonSchemaAttributes(jsonWriter);
+  if (this->_nextGroup != NULL)
+  {
+    jsonWriter->writeString("n", this->_nextGroup->getId());
+  }
+}
 
 }
\ No newline at end of file
@@ -21,7 +21,7 @@ const char IOTWEBCONF_HTML_FORM_OPTIONAL_GROUP_JAVASCRIPT[] PROGMEM =
   "    function val(id) { var x=document.getElementById(id); return x.value; }\n"
   "    function setVal(id, val) { var x=document.getElementById(id); x.value = val; }\n"
   "    function showFs(id) {\n"
-  "      show(id); hide(id + 'b'); setVal(id + 'v', 'active'); var n=document.getElementById(id + 'next');\n"
+  "      lg(id); show(id); hide(id + 'b'); setVal(id + 'v', 'active'); var n=document.getElementById(id + 'next');\n"
   "      if (n) { var nId = n.value; if (val(nId + 'v') == 'inactive') { show(nId + 'b'); }}\n"
   "    }\n"
   "    function hideFs(id) {\n"
@@ -36,6 +36,8 @@ const char IOTWEBCONF_HTML_FORM_OPTIONAL_GROUP_START[] PROGMEM =
   "<button onclick=\"hideFs('{i}'); return false;\">Remove this set</button>\n"
   "<input id='{i}v' name='{i}v' type='hidden' value='{v}'/>\n"
   "\n";
+const char IOTWEBCONF_HTML_FORM_OPTIONAL_GROUP_LAZY[] PROGMEM =
+  "<div id='{i}lz'><input type='hidden' name='{i}lazy' value='lazy'/></div>\n";
 const char IOTWEBCONF_HTML_FORM_OPTIONAL_GROUP_END[] PROGMEM =
   "</fieldset>\n";
 const char IOTWEBCONF_HTML_FORM_CHAINED_GROUP_NEXTID[] PROGMEM =
@@ -51,8 +53,14 @@ protected:
   {
     return
       HtmlFormatProvider::getScriptInner() +
+      String(FPSTR(IOTWEBCONF_HTML_LAZY_GROUP_SCRIPT_INNER)) +
       String(FPSTR(IOTWEBCONF_HTML_FORM_OPTIONAL_GROUP_JAVASCRIPT));
   }
+  String getLazyGroupScript() override
+  {
+    // -- Already part of the script.
+    return "";
+  }
   String getStyleInner() override
   {
     return
@@ -81,11 +89,18 @@ protected:
     SerializationData* serializationData)> doStore) override;
   void loadValue(std::function<void(
     SerializationData* serializationData)> doLoad) override;
-  void renderHtml(bool dataArrived, WebRequestWrapper* webRequestWrapper) override;
+  bool renderHtmlBegin(
+    bool dataArrived, WebRequestWrapper* webRequestWrapper) override;
+  void renderHtmlStart(WebRequestWrapper* webRequestWrapper) override;
   virtual String getStartTemplate() { return FPSTR(IOTWEBCONF_HTML_FORM_OPTIONAL_GROUP_START); };
   virtual String getEndTemplate() { return FPSTR(IOTWEBCONF_HTML_FORM_OPTIONAL_GROUP_END); };
+  virtual String getLazyTemplate() { return FPSTR(IOTWEBCONF_HTML_FORM_OPTIONAL_GROUP_LAZY); };
   void update(WebRequestWrapper* webRequestWrapper) override;
+  bool validate(WebRequestWrapper* webRequestWrapper) override;
   void debugTo(Stream* out) override;
+  void renderJson(JsonWriter* jsonWriter) override;
+  void renderChangedJson(JsonWriter* jsonWriter) override;
+  void renderJsonSchemaAttributes(JsonWriter* jsonWriter) override;
 
 private:
   bool _defaultActive;
@@ -105,6 +120,7 @@ public:
 protected:
   virtual String getStartTemplate() override;
   virtual String getEndTemplate() override;
+  void renderJsonSchemaAttributes(JsonWriter* jsonWriter) override;
 
 protected:
   ChainedParameterGroup* _prevGroup = NULL;
@@ -10,10 +10,155 @@
  */
 
 #include <IotWebConfParameter.h>
+#include <IotWebConfNumber.h>
 
 namespace iotwebconf
 {
 
+static bool isIpAddress(const char* value)
+{
+  // -- Four decimal numbers of 0-255, without leading zeros.
+  for (int part = 0; part < 4; part++)
+  {
+    if ((part > 0) && (*value++ != '.'))
+    {
+      return false;
+    }
+    int number = 0;
+    int digits = 0;
+    while (isdigit(*value))
+    {
+      if ((digits > 0) && (number == 0))
+      {
+        return false;
+      }
+      number = number * 10 + (*value++ - '0');
+      digits++;
+      if (number > 255)
+      {
+        return false;
+      }
+    }
+    if (digits == 0)
+    {
+      return false;
+    }
+  }
+  return *value == '\0';
+}
+
+static bool isHostname(const char* value)
+{
+  // -- Labels of 1-63 letters, digits and hyphens, separated by dots.
+  //    Labels must not start or end with a hyphen.
+  if (strlen(value) > 253)
+  {
+    return false;
+  }
+  while (true)
+  {
+    int length = 0;
+    while (isalnum(*value) || (*value == '-'))
+    {
+      if (((length == 0) && (*value == '-')) || (++length > 63))
+      {
+        return false;
+      }
+      value++;
+    }
+    if ((length == 0) || (value[-1] == '-'))
+    {
+      return false;
+    }
+    if (*value == '\0')
+    {
+      return true;
+    }
+    if (*value++ != '.')
+    {
+      return false;
+    }
+  }
+}
+
+const InputPattern ipAddressPattern =
+{
+  "((25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9]?[0-9])\\.){3}"
+  "(25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9]?[0-9])",
+  isIpAddress,
+  "Not a valid IP address."
+};
+const InputPattern hostnamePattern =
+{
+  "[A-Za-z0-9]([A-Za-z0-9\\-]{0,61}[A-Za-z0-9])?"
+  "(\\.[A-Za-z0-9]([A-Za-z0-9\\-]{0,61}[A-Za-z0-9])?)*",
+  isHostname,
+  "Not a valid host name."
+};
+
+String InputConstraints::renderHtml()
+{
+  String result;
+  if (this->required)
+  {
+    result += " required";
+  }
+  if (this->minLength > 0)
+  {
+    result += " minlength='";
+    result += this->minLength;
+    result += "'";
+  }
+  if (this->pattern != NULL)
+  {
+    result += " pattern='";
+    result += this->pattern->regex;
+    result += "'";
+  }
+  return result;
+}
+
+void InputConstraints::renderJsonSchema(JsonWriter* jsonWriter)
+{
+  if (this->required)
+  {
+    jsonWriter->writeBool("q", true);
+  }
+  if (this->minLength > 0)
+  {
+    jsonWriter->writeNumber("k", String(this->minLength).c_str());
+  }
+  if (this->pattern != NULL)
+  {
+    jsonWriter->writeString("x", this->pattern->regex);
+  }
+}
+
+const char* InputConstraints::check(const char* value)
+{
+  const char* message = NULL;
+  if (*value == '\0')
+  {
+    if (this->required)
+    {
+      message = "Value is required.";
+    }
+  }
+  else if ((int)strlen(value) < this->minLength)
+  {
+    message = "Value is too short.";
+  }
+  else if ((this->pattern != NULL) && !this->pattern->matches(value))
+  {
+    message = this->pattern->errorMessage;
+  }
+  if ((message != NULL) && (this->errorMessage != NULL))
+  {
+    message = this->errorMessage;
+  }
+  return message;
+}
+
 ParameterGroup::ParameterGroup(
   const char* id, const char* label) :
   ConfigItem(id)
@@ -86,32 +231,155 @@ void ParameterGroup::loadValue(
 void ParameterGroup::renderHtml(
   bool dataArrived, WebRequestWrapper* webRequestWrapper)
 {
-    if (this->label != NULL)
+  if (this->renderHtmlBegin(dataArrived, webRequestWrapper))
+  {
+    this->renderHtmlItems(dataArrived, webRequestWrapper);
+    this->renderHtmlEnd(webRequestWrapper);
+  }
+}
+bool ParameterGroup::renderHtmlBegin(
+  bool dataArrived, WebRequestWrapper* webRequestWrapper)
+{
+  this->renderHtmlStart(webRequestWrapper);
+  return true;
+}
+bool ParameterGroup::renderLazyHtml(
+  bool dataArrived, WebRequestWrapper* webRequestWrapper)
+{
+  if (this->label == NULL)
+  {
+    return false;
+  }
+  String lazyId = String(this->getId());
+  lazyId += "lazy";
+  if (dataArrived && !webRequestWrapper->hasArg(lazyId))
+  {
+    // -- Group was loaded before the post, values (and errors) must be shown.
+    return false;
+  }
+  this->renderHtmlStart(webRequestWrapper);
+  String content = getLazyTemplate();
+  content.replace("{b}", this->label);
+  content.replace("{i}", this->getId());
+  webRequestWrapper->sendContent(content);
+  this->renderHtmlEnd(webRequestWrapper);
+  return true;
+}
+void ParameterGroup::renderHtmlItems(
+  bool dataArrived, WebRequestWrapper* webRequestWrapper, bool lazy)
+{
+  HtmlRenderCursor cursor(this, dataArrived, lazy);
+  while (cursor.renderNext(webRequestWrapper))
+  {
+  }
+}
+void ParameterGroup::renderHtmlStart(WebRequestWrapper* webRequestWrapper)
+{
+  if (this->label != NULL)
+  {
+    String content = getStartTemplate();
+    content.replace("{b}", this->label);
+    content.replace("{i}", this->getId());
+    webRequestWrapper->sendContent(content);
+  }
+}
+void ParameterGroup::renderHtmlEnd(WebRequestWrapper* webRequestWrapper)
+{
+  if (this->label != NULL)
+  {
+    String content = getEndTemplate();
+    content.replace("{b}", this->label);
+    content.replace("{i}", this->getId());
+    webRequestWrapper->sendContent(content);
+  }
+}
+ParameterGroup* ParameterGroup::findGroup(const char* id)
+{
+  if (strcmp(this->getId(), id) == 0)
+  {
+    return this;
+  }
+  ConfigItem* current = this->_firstItem;
+  while (current != NULL)
+  {
+    ParameterGroup* found = current->findGroup(id);
+    if (found != NULL)
     {
-      String content = getStartTemplate();
-      content.replace("{b}", this->label);
-      content.replace("{i}", this->getId());
-      webRequestWrapper->sendContent(content);
+      return found;
     }
-    ConfigItem* current = this->_firstItem;
-    while (current != NULL)
+    current = current->_nextItem;
+  }
+  return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+HtmlRenderCursor::HtmlRenderCursor(
+  ParameterGroup* group, bool dataArrived, bool lazy)
+{
+  this->_dataArrived = dataArrived;
+  this->_levels[0].group = group;
+  this->_levels[0].next = group->_firstItem;
+  this->_levels[0].lazy = lazy;
+  this->_depth = 1;
+}
+
+bool HtmlRenderCursor::renderNext(WebRequestWrapper* webRequestWrapper)
+{
+  while (this->_depth > 0)
+  {
+    Level* level = &this->_levels[this->_depth - 1];
+    if (level->next == NULL)
     {
-      if (current->visible)
+      // -- All items of the group are done. Frame of the outermost group
+      //    is not rendered by the cursor.
+      this->_depth--;
+      if (this->_depth > 0)
       {
-        current->renderHtml(dataArrived, webRequestWrapper);
+        level->group->renderHtmlEnd(webRequestWrapper);
+        return true;
       }
-      current = current->_nextItem;
+      return false;
     }
-    if (this->label != NULL)
+    ConfigItem* current = level->next;
+    level->next = current->_nextItem;
+    if (!current->visible)
     {
-      String content = getEndTemplate();
-      content.replace("{b}", this->label);
-      content.replace("{i}", this->getId());
-      webRequestWrapper->sendContent(content);
+      continue;
     }
+    if (level->lazy
+      && current->renderLazyHtml(this->_dataArrived, webRequestWrapper))
+    {
+      return true;
+    }
+    ParameterGroup* group = current->asGroup();
+    if ((group == NULL) || (this->_depth >= IOTWEBCONF_HTML_RENDER_MAX_DEPTH))
+    {
+      current->renderHtml(this->_dataArrived, webRequestWrapper);
+      return true;
+    }
+    if (group->renderHtmlBegin(this->_dataArrived, webRequestWrapper))
+    {
+      Level* nested = &this->_levels[this->_depth];
+      nested->group = group;
+      nested->next = group->_firstItem;
+      nested->lazy = false;
+      this->_depth++;
+    }
+    return true;
+  }
+  return false;
 }
 void ParameterGroup::update(WebRequestWrapper* webRequestWrapper)
 {
+  this->clearChanged();
+  String lazyId = String(this->getId());
+  lazyId += "lazy";
+  if (webRequestWrapper->hasArg(lazyId))
+  {
+    // -- Items were not loaded by the client, thus were not posted.
+    return;
+  }
   ConfigItem* current = this->_firstItem;
   while (current != NULL)
   {
@@ -119,6 +387,28 @@ void ParameterGroup::update(WebRequestWrapper* webRequestWrapper)
     current = current->_nextItem;
   }
 }
+bool ParameterGroup::validate(WebRequestWrapper* webRequestWrapper)
+{
+  String lazyId = String(this->getId());
+  lazyId += "lazy";
+  if (webRequestWrapper->hasArg(lazyId))
+  {
+    // -- Items were not loaded by the client, thus were not posted.
+    return true;
+  }
+  // -- All items are validated, so that all error messages are set.
+  bool valid = true;
+  ConfigItem* current = this->_firstItem;
+  while (current != NULL)
+  {
+    if (current->visible && !current->validate(webRequestWrapper))
+    {
+      valid = false;
+    }
+    current = current->_nextItem;
+  }
+  return valid;
+}
 void ParameterGroup::clearErrorMessage()
 {
   ConfigItem* current = this->_firstItem;
@@ -128,6 +418,80 @@ void ParameterGroup::clearErrorMessage()
     current = current->_nextItem;
   }
 }
+void ParameterGroup::renderJson(JsonWriter* jsonWriter)
+{
+  ConfigItem* current = this->_firstItem;
+  while (current != NULL)
+  {
+    if (current->visible)
+    {
+      current->renderJson(jsonWriter);
+    }
+    current = current->_nextItem;
+  }
+}
+void ParameterGroup::clearChanged()
+{
+  ConfigItem* current = this->_firstItem;
+  while (current != NULL)
+  {
+    current->_changed = false;
+    ParameterGroup* group = current->asGroup();
+    if (group != NULL)
+    {
+      group->clearChanged();
+    }
+    current = current->_nextItem;
+  }
+}
+void ParameterGroup::renderChangedJson(JsonWriter* jsonWriter)
+{
+  ConfigItem* current = this->_firstItem;
+  while (current != NULL)
+  {
+    if (current->visible)
+    {
+      current->renderChangedJson(jsonWriter);
+    }
+    current = current->_nextItem;
+  }
+}
+void ParameterGroup::renderJsonError(JsonWriter* jsonWriter)
+{
+  ConfigItem* current = this->_firstItem;
+  while (current != NULL)
+  {
+    current->renderJsonError(jsonWriter);
+    current = current->_nextItem;
+  }
+}
+void ParameterGroup::renderJsonSchema(JsonWriter* jsonWriter)
+{
+  // -- Groups without label are not shown as separate fieldset, so
+  //    items are rendered into the parent.
+  if (this->label != NULL)
+  {
+    jsonWriter->beginObject();
+    jsonWriter->writeString("g", this->getId());
+    jsonWriter->writeString("l", this->label);
+    this->renderJsonSchemaAttributes(jsonWriter);
+    jsonWriter->beginArray("i");
+  }
+  ConfigItem* current = this->_firstItem;
+  while (current != NULL)
+  {
+    if (current->visible)
+    {
+      current->renderJsonSchema(jsonWriter);
+    }
+    current = current->_nextItem;
+  }
+  if (this->label != NULL)
+  {
+    jsonWriter->endArray();
+    jsonWriter->endObject();
+  }
+}
 void ParameterGroup::debugTo(Stream* out)
 {
   out->print('[');
@@ -232,6 +596,13 @@ void Parameter::clearErrorMessage()
 {
     this->errorMessage = NULL;
 }
+void Parameter::renderJsonError(JsonWriter* jsonWriter)
+{
+  if (this->errorMessage != NULL)
+  {
+    jsonWriter->writeString(this->getId(), this->errorMessage);
+  }
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -264,7 +635,7 @@ String TextParameter::renderHtml(
   const char* type, bool hasValueFromPost, String valueFromPost)
 {
   TextParameter* current = this;
-  char parLength[5];
+  char parLength[IOTWEBCONF_NUMBER_TEXT_SIZE];
 
   String pitem = getHtmlTemplate();
 
@@ -272,8 +643,9 @@ String TextParameter::renderHtml(
   pitem.replace("{t}", type);
   pitem.replace("{i}", current->getId());
   pitem.replace("{p}", current->placeholder == NULL ? "" : current->placeholder);
-  snprintf(parLength, 5, "%d", current->getLength()-1);
-  pitem.replace("{l}", parLength);
+  formatUnsigned(current->getLength() - 1, parLength, sizeof(parLength));
+  String maxLength = String("maxlength='") + parLength + "'";
+  pitem.replace("{l}", maxLength + current->constraints.renderHtml());
   if (hasValueFromPost)
   {
     // -- Value from previous submit
@@ -296,8 +668,43 @@ String TextParameter::renderHtml(
   return pitem;
 }
 
+bool TextParameter::validate(WebRequestWrapper* webRequestWrapper)
+{
+  if (webRequestWrapper->hasArg(this->getId()))
+  {
+    String newValue = webRequestWrapper->arg(this->getId());
+    const char* message = this->constraints.check(newValue.c_str());
+    if (message != NULL)
+    {
+      if (this->errorMessage == NULL)
+      {
+        this->errorMessage = message;
+      }
+      return false;
+    }
+  }
+  else if (this->visible && !webRequestWrapper->isPartial())
+  {
+    // -- Left out of a full post: a required value can not be skipped.
+    const char* message = this->constraints.check("");
+    if (message != NULL)
+    {
+      if (this->errorMessage == NULL)
+      {
+        this->errorMessage = message;
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
 void TextParameter::update(String newValue)
 {
+  if (strncmp(newValue.c_str(), this->valueBuffer, this->getLength() - 1) != 0)
+  {
+    this->markChanged();
+  }
   newValue.toCharArray(this->valueBuffer, this->getLength());
 #ifdef IOTWEBCONF_DEBUG_TO_SERIAL
   Serial.print(this->getId());
@@ -306,6 +713,39 @@ void TextParameter::update(String newValue)
 #endif
 }
 
+void TextParameter::renderJson(JsonWriter* jsonWriter)
+{
+  this->renderJsonValue(jsonWriter, this->getId());
+}
+void TextParameter::renderJsonValue(JsonWriter* jsonWriter, const char* key)
+{
+  jsonWriter->writeString(key, this->valueBuffer);
+}
+void TextParameter::renderJsonSchema(JsonWriter* jsonWriter)
+{
+  char parLength[IOTWEBCONF_NUMBER_TEXT_SIZE];
+  formatUnsigned(this->getLength() - 1, parLength, sizeof(parLength));
+
+  jsonWriter->beginObject();
+  jsonWriter->writeString("i", this->getId());
+  jsonWriter->writeString("l", this->label);
+  jsonWriter->writeString("t", this->getJsonSchemaType());
+  jsonWriter->writeNumber("m", parLength);
+  if (this->placeholder != NULL)
+  {
+    jsonWriter->writeString("p", this->placeholder);
+  }
+  const char* customHtml = this->getJsonSchemaCustomHtml();
+  if (customHtml != NULL)
+  {
+    jsonWriter->writeString("c", customHtml);
+  }
+  this->constraints.renderJsonSchema(jsonWriter);
+  this->renderJsonSchemaAttributes(jsonWriter);
+  this->renderJsonValue(jsonWriter, "v");
+  jsonWriter->endObject();
+}
+
 void TextParameter::debugTo(Stream* out)
 {
   Parameter* current = this;
@@ -379,6 +819,10 @@ void PasswordParameter::update(String newValue)
   if (newValue.length() > 0)
   {
     // -- Value was set.
+    if (strncmp(newValue.c_str(), current->valueBuffer, current->getLength() - 1) != 0)
+    {
+      this->markChanged();
+    }
     newValue.toCharArray(current->valueBuffer, current->getLength());
 #ifdef IOTWEBCONF_DEBUG_TO_SERIAL
 # ifdef IOTWEBCONF_DEBUG_PWD_TO_SERIAL
@@ -446,13 +890,18 @@ void CheckboxParameter::update(WebRequestWrapper* webRequestWrapper)
     String newValue = webRequestWrapper->arg(this->getId());
     return TextParameter::update(newValue);
   }
-  else if (this->visible)
+  else if (this->visible && !webRequestWrapper->isPartial())
   {
     // HTML will not post back unchecked checkboxes.
     return TextParameter::update("");
   }
 }
 
+void CheckboxParameter::renderJsonValue(JsonWriter* jsonWriter, const char* key)
+{
+  jsonWriter->writeBool(key, this->isChecked());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 OptionsParameter::OptionsParameter(
@@ -533,6 +982,19 @@ String SelectParameter::renderHtml(
   return pitem;
 }
 
+void SelectParameter::renderJsonSchemaAttributes(JsonWriter* jsonWriter)
+{
+  jsonWriter->beginArray("o");
+  for (size_t i=0; i<this->_optionCount; i++)
+  {
+    jsonWriter->beginArray();
+    jsonWriter->writeString(NULL, this->_optionValues + (i*this->getLength()));
+    jsonWriter->writeString(NULL, this->_optionNames + (i*this->_nameLength));
+    jsonWriter->endArray();
+  }
+  jsonWriter->endArray();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 PrefixStreamWrapper::PrefixStreamWrapper(
@@ -16,11 +16,15 @@
 #include <functional>
 #include <IotWebConfSettings.h>
 #include <IotWebConfWebServerWrapper.h>
+#include <IotWebConfJson.h>
 
 const char IOTWEBCONF_HTML_FORM_GROUP_START[] PROGMEM =
   "<fieldset id='{i}'><legend>{b}</legend>\n";
 const char IOTWEBCONF_HTML_FORM_GROUP_END[] PROGMEM =
   "</fieldset>\n";
+const char IOTWEBCONF_HTML_FORM_GROUP_LAZY[] PROGMEM =
+  "<div id='{i}lz'><input type='hidden' name='{i}lazy' value='lazy'/>"
+  "<button onclick=\"lg('{i}'); return false;\">Show {b}</button></div>\n";
 
 const char IOTWEBCONF_HTML_FORM_PARAM[] PROGMEM =
   "<div class='{s}'><label for='{i}'>{b}</label><input type='{t}' id='{i}' "
@@ -43,6 +47,61 @@ typedef struct SerializationData
   int length;
 } SerializationData;
 
+/**
+ * Pattern a text value must match. The regular expression is rendered as
+ * the HTML "pattern" attribute for the browser, while the very same rule is
+ * checked on the device by the 'matches' function (as there is no regular
+ * expression engine on the device).
+ */
+typedef struct InputPattern
+{
+  const char* regex;
+  bool (*matches)(const char* value);
+  const char* errorMessage;
+} InputPattern;
+
+/**
+ * Dotted decimal IPv4 address, e.g. 192.168.4.1 .
+ */
+extern const InputPattern ipAddressPattern;
+/**
+ * Host name (or domain name) of letters, digits and hyphens, e.g.
+ *   mything.local .
+ */
+extern const InputPattern hostnamePattern;
+
+/**
+ * Constraints of an input field. These are rendered as HTML5 attributes,
+ * so that most invalid values are rejected by the browser, and the same
+ * rules are checked on the device when the form is posted.
+ */
+class InputConstraints
+{
+public:
+  bool required = false;
+  int minLength = 0;
+  const InputPattern* pattern = NULL;
+  /**
+   * Message to show instead of the generic ones, when a constraint is
+   *   not met.
+   */
+  const char* errorMessage = NULL;
+
+  /**
+   * Returns the HTML attributes (required, minlength, pattern) to be added
+   *   to the input field.
+   */
+  String renderHtml();
+  void renderJsonSchema(JsonWriter* jsonWriter);
+  /**
+   * Returns an error message, or NULL if the value is accepted. As in HTML,
+   *   minLength and pattern are not checked on an empty value.
+   */
+  const char* check(const char* value);
+};
+
+class ParameterGroup;
+
 class ConfigItem
 {
 public:
@@ -87,6 +146,20 @@ public:
    */
   virtual void renderHtml(bool dataArrived, WebRequestWrapper* webRequestWrapper) = 0;
 
+  /**
+   * Render a placeholder instead of the HTML form item. The client fetches
+   *   the actual content on demand (see IotWebConf::setLazyGroupLoading()).
+   *   Should return false, if the item does not support lazy loading, and
+   *   must be rendered as a whole.
+   */
+  virtual bool renderLazyHtml(bool dataArrived, WebRequestWrapper* webRequestWrapper) { return false; };
+
+  /**
+   * Returns the group with the given ID, if this item is that group,
+   *   or the group is contained by this item. Returns NULL otherwise.
+   */
+  virtual ParameterGroup* findGroup(const char* id) { return NULL; };
+
   /**
    * New value arrived from the form post. The value should be stored in the
    *   in this config item.
@@ -97,6 +170,14 @@ public:
    */
   virtual void update(WebRequestWrapper* webRequestWrapper) = 0;
 
+  /**
+   * Check the value arrived from the form post without storing it. All
+   *   items are validated before any of them is updated, so a rejected
+   *   post leaves all values untouched. An error message should be set
+   *   when the value is not valid.
+   */
+  virtual bool validate(WebRequestWrapper* webRequestWrapper) { return true; };
+
   /**
    * Before validating the form post, it is required to clear previos error messages.
    */
@@ -109,14 +190,66 @@ public:
    */
   virtual void debugTo(Stream* out) = 0;
 
+  /**
+   * This method should write the current value of the config item as
+   *   JSON member, where the key is the ID of the item. Items not
+   *   overriding this method are left out from the JSON representation.
+   *
+   * @jsonWriter - The writer that will send the rendered content to the client.
+   */
+  virtual void renderJson(JsonWriter* jsonWriter) { };
+
+  /**
+   * Same as renderJson(), but only if the value was changed by the last
+   *   update() (see markChanged()).
+   */
+  virtual void renderChangedJson(JsonWriter* jsonWriter)
+  {
+    if (this->isChanged())
+    {
+      this->renderJson(jsonWriter);
+    }
+  };
+
+  /**
+   * This method should write the error message of the last validation
+   *   (if there is any) as JSON member, where the key is the ID of the item.
+   */
+  virtual void renderJsonError(JsonWriter* jsonWriter) { };
+
+  /**
+   * This method should write a JSON object describing the config item
+   *   (ID, label, input type, limits, actual value, etc.), so that the
+   *   client can render the input field by itself. Items not overriding
+   *   this method are left out from the client rendered config portal.
+   */
+  virtual void renderJsonSchema(JsonWriter* jsonWriter) { };
+
 protected:
   ConfigItem(const char* id) { this->_id = id; };
 
+  /**
+   * Groups return themselves, so that their items can be rendered one by
+   *   one (see HtmlRenderCursor). A group rendering its HTML in a custom
+   *   way (overriding renderHtml()) should return NULL.
+   */
+  virtual ParameterGroup* asGroup() { return NULL; };
+
+  /**
+   * Implementations of update() should call this, when the value stored
+   *   differs from the previous one, so that viewers of the event stream
+   *   are sent the new value (see IotWebConf::handleEvents()).
+   */
+  void markChanged() { this->_changed = true; };
+  bool isChanged() { return this->_changed; };
+
 private:
   const char* _id = 0;
   ConfigItem* _parentItem = NULL;
   ConfigItem* _nextItem = NULL;
+  bool _changed = false;
   friend class ParameterGroup; // Allow ParameterGroup to access _nextItem.
+  friend class HtmlRenderCursor; // Allow HtmlRenderCursor to walk the items.
 };
 
 class ParameterGroup : public ConfigItem
@@ -134,9 +267,45 @@ protected:
   void loadValue(std::function<void(
     SerializationData* serializationData)> doLoad) override;
   void renderHtml(bool dataArrived, WebRequestWrapper* webRequestWrapper) override;
+  bool renderLazyHtml(bool dataArrived, WebRequestWrapper* webRequestWrapper) override;
+  ParameterGroup* findGroup(const char* id) override;
   void update(WebRequestWrapper* webRequestWrapper) override;
+  bool validate(WebRequestWrapper* webRequestWrapper) override;
   void clearErrorMessage() override;
   void debugTo(Stream* out) override;
+  void renderJson(JsonWriter* jsonWriter) override;
+  void renderChangedJson(JsonWriter* jsonWriter) override;
+  void renderJsonError(JsonWriter* jsonWriter) override;
+  void renderJsonSchema(JsonWriter* jsonWriter) override;
+  /**
+   * Render the items of the group without the group frame. When lazy is
+   *   set, items supporting it are rendered as placeholders.
+   */
+  void renderHtmlItems(
+    bool dataArrived, WebRequestWrapper* webRequestWrapper, bool lazy = false);
+  /**
+   * One can override these methods in case the group frame needs some
+   * values beyond the label and the ID to be filled in the templates.
+   */
+  virtual void renderHtmlStart(WebRequestWrapper* webRequestWrapper);
+  virtual void renderHtmlEnd(WebRequestWrapper* webRequestWrapper);
+  /**
+   * Renders the start of the group, and returns true if the items and the
+   *   end of the group should follow. Returns false, if the group was
+   *   rendered as a whole (e.g. as a lazy placeholder).
+   */
+  virtual bool renderHtmlBegin(
+    bool dataArrived, WebRequestWrapper* webRequestWrapper);
+  ParameterGroup* asGroup() override { return this; };
+  /**
+   * Forget the changes of the items (see markChanged()) before an update.
+   */
+  void clearChanged();
+  /**
+   * One can override this method to add group specific members to the
+   * JSON schema of the group.
+   */
+  virtual void renderJsonSchemaAttributes(JsonWriter* jsonWriter) { };
   /**
    * One can override this method in case a specific HTML template is required
    * for a group.
@@ -147,15 +316,55 @@ protected:
    * for a group.
    */
   virtual String getEndTemplate() { return FPSTR(IOTWEBCONF_HTML_FORM_GROUP_END); };
+  /**
+   * One can override this method in case a specific HTML template is required
+   * for the placeholder of a lazy loaded group.
+   */
+  virtual String getLazyTemplate() { return FPSTR(IOTWEBCONF_HTML_FORM_GROUP_LAZY); };
 
   ConfigItem* _firstItem = NULL;
   ConfigItem* getNextItemOf(ConfigItem* parent) { return parent->_nextItem; };
 
   friend class IotWebConf; // Allow IotWebConf to access protected members.
+  friend class HtmlRenderCursor; // Allow HtmlRenderCursor to render parts.
 
 private:
 };
 
+/**
+ * Renders the items of a group one by one, so that rendering a large
+ * config page can be cut into slices, and other work can be done between
+ * the slices. Nested groups are walked into, the output is the same as of
+ * ParameterGroup::renderHtmlItems().
+ */
+class HtmlRenderCursor
+{
+public:
+  /**
+   * @lazy - Items of the group (but not of the nested groups) supporting
+   *   it are rendered as lazy placeholders.
+   */
+  HtmlRenderCursor(ParameterGroup* group, bool dataArrived, bool lazy = false);
+
+  /**
+   * Render the next piece (an item, or the start or end of a nested group).
+   *   Returns false, when there was nothing left to render.
+   */
+  bool renderNext(WebRequestWrapper* webRequestWrapper);
+
+private:
+  typedef struct Level
+  {
+    ParameterGroup* group;
+    ConfigItem* next;
+    bool lazy;
+  } Level;
+
+  Level _levels[IOTWEBCONF_HTML_RENDER_MAX_DEPTH];
+  int _depth = 0;
+  bool _dataArrived;
+};
+
 /**
  * Parameters is a configuration item of the config portal.
  * The parameter will have its input field on the configuration page,
@@ -194,8 +403,9 @@ protected:
   void storeValue(std::function<void(SerializationData* serializationData)> doStore) override;
   void loadValue(std::function<void(SerializationData* serializationData)> doLoad) override;
   virtual void update(WebRequestWrapper* webRequestWrapper) override;
-  virtual void update(String newValue);
+  virtual void update(String newValue) = 0;
   void clearErrorMessage() override;
+  void renderJsonError(JsonWriter* jsonWriter) override;
 
 private:
   int _length;
@@ -235,19 +445,46 @@ public:
    */
   const char* customHtml;
 
+  /**
+   * Rules for the value, rendered into the input field, and checked
+   *   when the form is posted.
+   */
+  InputConstraints constraints;
+
 protected:
   virtual String renderHtml(
     bool dataArrived, bool hasValueFromPost, String valueFromPost);
   // Overrides
   virtual void renderHtml(bool dataArrived, WebRequestWrapper* webRequestWrapper) override;
+  virtual bool validate(WebRequestWrapper* webRequestWrapper) override;
   virtual void update(String newValue) override;
   virtual void debugTo(Stream* out) override;
+  virtual void renderJson(JsonWriter* jsonWriter) override;
+  virtual void renderJsonSchema(JsonWriter* jsonWriter) override;
   /**
    * One can override this method in case a specific HTML template is required
    * for a parameter.
    */
   virtual String getHtmlTemplate() { return FPSTR(IOTWEBCONF_HTML_FORM_PARAM); };
 
+  /**
+   * Writes the value of the parameter as JSON member with the key provided.
+   */
+  virtual void renderJsonValue(JsonWriter* jsonWriter, const char* key);
+  /**
+   * Input type of the parameter in the JSON schema.
+   */
+  virtual const char* getJsonSchemaType() { return "text"; };
+  /**
+   * Custom HTML of the input field in the JSON schema.
+   */
+  virtual const char* getJsonSchemaCustomHtml() { return this->customHtml; };
+  /**
+   * One can override this method to add type specific members to the
+   * JSON schema of the parameter.
+   */
+  virtual void renderJsonSchemaAttributes(JsonWriter* jsonWriter) { };
+
   /**
    * Renders a standard HTML form INPUT.
    * @type - The type attribute of the html input field.
@@ -287,6 +524,11 @@ protected:
     bool dataArrived, bool hasValueFromPost, String valueFromPost) override;
   virtual void update(String newValue) override;
   virtual void debugTo(Stream* out) override;
+  /**
+   * Password is never sent out.
+   */
+  virtual void renderJsonValue(JsonWriter* jsonWriter, const char* key) override { };
+  virtual const char* getJsonSchemaType() override { return "password"; };
 
 private:
   friend class IotWebConf;
@@ -316,6 +558,7 @@ protected:
   // Overrides
   virtual String renderHtml(
     bool dataArrived, bool hasValueFromPost, String valueFromPost) override;
+  virtual const char* getJsonSchemaType() override { return "number"; };
 
 private:
   friend class IotWebConf;
@@ -346,6 +589,12 @@ protected:
   virtual String renderHtml(
     bool dataArrived, bool hasValueFromPost, String valueFromPost) override;
   virtual void update(WebRequestWrapper* webRequestWrapper) override;
+  virtual void renderJsonValue(JsonWriter* jsonWriter, const char* key) override;
+  virtual const char* getJsonSchemaType() override { return "checkbox"; };
+  /**
+   * Custom HTML is only used for rendering the checked state.
+   */
+  virtual const char* getJsonSchemaCustomHtml() override { return NULL; };
 
 private:
   friend class IotWebConf;
@@ -410,6 +659,8 @@ protected:
   // Overrides
   virtual String renderHtml(
     bool dataArrived, bool hasValueFromPost, String valueFromPost) override;
+  virtual const char* getJsonSchemaType() override { return "select"; };
+  virtual void renderJsonSchemaAttributes(JsonWriter* jsonWriter) override;
 
 private:
   friend class IotWebConf;
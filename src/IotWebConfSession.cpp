@@ -0,0 +1,128 @@
+/**
+ * IotWebConfSession.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <IotWebConfSession.h>
+
+namespace iotwebconf
+{
+
+static const char hexDigits[] PROGMEM = "0123456789abcdef";
+
+static uint32_t randomWord()
+{
+#ifdef ESP8266
+  // -- Hardware random number generator.
+  return RANDOM_REG32;
+#else
+  return esp_random();
+#endif
+}
+
+static int hexValue(char c)
+{
+  if ((c >= '0') && (c <= '9'))
+  {
+    return c - '0';
+  }
+  if ((c >= 'a') && (c <= 'f'))
+  {
+    return c - 'a' + 10;
+  }
+  if ((c >= 'A') && (c <= 'F'))
+  {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+void SessionCache::open(unsigned long now, char* tokenHex)
+{
+  // -- A free (or expired) place, or the least recently used one.
+  Session* session = &this->_sessions[0];
+  for (Session& candidate : this->_sessions)
+  {
+    if (!this->isAlive(&candidate, now))
+    {
+      session = &candidate;
+      break;
+    }
+    if (now - candidate.lastUsed > now - session->lastUsed)
+    {
+      session = &candidate;
+    }
+  }
+
+  for (size_t i = 0; i < IOTWEBCONF_SESSION_TOKEN_BYTES; i += 4)
+  {
+    uint32_t word = randomWord();
+    memcpy(session->token + i, &word, 4);
+  }
+  session->lastUsed = now;
+  session->open = true;
+
+  for (size_t i = 0; i < IOTWEBCONF_SESSION_TOKEN_BYTES; i++)
+  {
+    tokenHex[i * 2] = pgm_read_byte(hexDigits + (session->token[i] >> 4));
+    tokenHex[i * 2 + 1] = pgm_read_byte(hexDigits + (session->token[i] & 0x0F));
+  }
+  tokenHex[IOTWEBCONF_SESSION_TOKEN_HEX_LENGTH] = '\0';
+}
+
+bool SessionCache::validate(
+  const char* tokenHex, size_t length, unsigned long now)
+{
+  if (length != IOTWEBCONF_SESSION_TOKEN_HEX_LENGTH)
+  {
+    return false;
+  }
+  uint8_t token[IOTWEBCONF_SESSION_TOKEN_BYTES];
+  for (size_t i = 0; i < IOTWEBCONF_SESSION_TOKEN_BYTES; i++)
+  {
+    int high = hexValue(tokenHex[i * 2]);
+    int low = hexValue(tokenHex[i * 2 + 1]);
+    if ((high < 0) || (low < 0))
+    {
+      return false;
+    }
+    token[i] = (high << 4) | low;
+  }
+
+  Session* found = NULL;
+  for (Session& session : this->_sessions)
+  {
+    uint8_t difference = 0;
+    for (size_t i = 0; i < IOTWEBCONF_SESSION_TOKEN_BYTES; i++)
+    {
+      difference |= session.token[i] ^ token[i];
+    }
+    if ((difference == 0) && this->isAlive(&session, now))
+    {
+      found = &session;
+    }
+  }
+  if (found == NULL)
+  {
+    return false;
+  }
+  found->lastUsed = now;
+  return true;
+}
+
+void SessionCache::clear()
+{
+  for (Session& session : this->_sessions)
+  {
+    memset(session.token, 0, sizeof(session.token));
+    session.open = false;
+  }
+}
+
+} // end namespace
@@ -0,0 +1,73 @@
+/**
+ * IotWebConfSession.h -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef IotWebConfSession_h
+#define IotWebConfSession_h
+
+#include <Arduino.h>
+#include <IotWebConfSettings.h>
+
+// -- Random bytes of a session token. Tokens are passed around as twice
+//    as many hex digits.
+#define IOTWEBCONF_SESSION_TOKEN_BYTES 16
+#define IOTWEBCONF_SESSION_TOKEN_HEX_LENGTH (IOTWEBCONF_SESSION_TOKEN_BYTES * 2)
+
+namespace iotwebconf
+{
+
+/**
+ * Sessions opened for browsers, that have passed the authentication. The
+ * browser presents the random token of its session (e.g. in a cookie) with
+ * the following requests, and a valid token replaces checking the
+ * credentials again. A fixed number of sessions are kept, the least
+ * recently used one is dropped, when a new one is opened.
+ */
+class SessionCache
+{
+public:
+  /**
+   * Open a new session. The token of the session is written into tokenHex
+   *   as IOTWEBCONF_SESSION_TOKEN_HEX_LENGTH hex digits, and a terminating
+   *   zero.
+   */
+  void open(unsigned long now, char* tokenHex);
+  /**
+   * Returns true, if the token belongs to an open session, that has not
+   *   expired. The session is kept alive by this call. The token is
+   *   compared with every session byte by byte till the end, so the time
+   *   spent does not tell how much of a guess was right.
+   */
+  bool validate(const char* tokenHex, size_t length, unsigned long now);
+  /**
+   * Drop all sessions, e.g. when the password was changed.
+   */
+  void clear();
+
+private:
+  typedef struct Session
+  {
+    uint8_t token[IOTWEBCONF_SESSION_TOKEN_BYTES];
+    unsigned long lastUsed;
+    bool open;
+  } Session;
+
+  Session _sessions[IOTWEBCONF_SESSION_COUNT] = {};
+
+  bool isAlive(const Session* session, unsigned long now)
+  {
+    return session->open
+      && (now - session->lastUsed < IOTWEBCONF_SESSION_TIMEOUT_MILLIS);
+  }
+};
+
+} // end namespace
+
+#endif
@@ -34,6 +34,20 @@
 # define IOTWEBCONF_CONFIG_USE_MDNS
 #endif
 
+// -- Pages are rendered twice: first only to count the content length, so
+// that responses can be sent with exact Content-Length instead of chunked
+// encoding. Costs some CPU, saves bytes and works with clients not
+// knowing chunked encoding.
+#ifndef IOTWEBCONF_CONFIG_DONT_CALCULATE_CONTENT_LENGTH
+# define IOTWEBCONF_CONFIG_CALCULATE_CONTENT_LENGTH
+#endif
+
+// -- Fields of inactive optional groups are not rendered on the config page,
+// but fetched by the browser when the group gets activated. Requires the
+// scripts of OptionalGroupHtmlFormatProvider (lg()), a custom
+// HtmlFormatProvider without them would show empty groups.
+//#define IOTWEBCONF_CONFIG_RENDER_INACTIVE_GROUPS_LAZY
+
 // -- Logs progress information to Serial if enabled.
 #ifndef IOTWEBCONF_DEBUG_DISABLED
 # define IOTWEBCONF_DEBUG_TO_SERIAL
@@ -54,8 +68,160 @@
 # define IOTWEBCONF_CONFIG_VERSION_LENGTH 4
 #endif
 
+// -- Config page is rendered in slices of at most this many items or this
+// long (microseconds). DNS and the loop tasks are served between slices.
+#ifndef IOTWEBCONF_HTML_RENDER_SLICE_ITEMS
+# define IOTWEBCONF_HTML_RENDER_SLICE_ITEMS 8
+#endif
+#ifndef IOTWEBCONF_HTML_RENDER_SLICE_MICROS
+# define IOTWEBCONF_HTML_RENDER_SLICE_MICROS 5000
+#endif
+// -- Groups nested deeper than this are rendered in one piece.
+#ifndef IOTWEBCONF_HTML_RENDER_MAX_DEPTH
+# define IOTWEBCONF_HTML_RENDER_MAX_DEPTH 6
+#endif
+
+// -- JSON output is sent to the client in chunks of about this size.
+#ifndef IOTWEBCONF_JSON_CHUNK_SIZE
+# define IOTWEBCONF_JSON_CHUNK_SIZE 256
+#endif
+
 #ifndef IOTWEBCONF_DNS_PORT
 # define IOTWEBCONF_DNS_PORT 53
 #endif
 
+// -- CaptiveDnsServer answers queries waiting for at most this long in one
+// loop pass.
+#ifndef IOTWEBCONF_DNS_TIME_BUDGET_MICROS
+# define IOTWEBCONF_DNS_TIME_BUDGET_MICROS 2000
+#endif
+// -- Time (microseconds) a doLoop() call may spend with its tasks. Tasks are
+// not interrupted, so the last task may still run longer.
+#ifndef IOTWEBCONF_LOOP_BUDGET_MICROS
+# define IOTWEBCONF_LOOP_BUDGET_MICROS 20000
+#endif
+// -- IotWebConf::delay() sleeps at most this long (milliseconds) between
+// loop passes with nothing to do. This is the latency of a new request.
+#ifndef IOTWEBCONF_IDLE_SLEEP_MAX_MILLIS
+# define IOTWEBCONF_IDLE_SLEEP_MAX_MILLIS 8
+#endif
+// -- While no station is connected to the AP, no request came in for
+// IOTWEBCONF_PORTAL_ACTIVE_HOLD_MILLIS, and no event stream is open, DNS and
+// HTTP requests are only polled once in every
+// IOTWEBCONF_PORTAL_HEARTBEAT_MILLIS. (0 disables this.)
+#ifndef IOTWEBCONF_PORTAL_HEARTBEAT_MILLIS
+# define IOTWEBCONF_PORTAL_HEARTBEAT_MILLIS 50
+#endif
+#ifndef IOTWEBCONF_PORTAL_ACTIVE_HOLD_MILLIS
+# define IOTWEBCONF_PORTAL_ACTIVE_HOLD_MILLIS 5000
+#endif
+// -- AsyncWebServerWrapper serves at most this many clients in parallel.
+// (Each holds its request arguments and its whole response in memory.)
+#ifndef IOTWEBCONF_ASYNC_MAX_CLIENTS
+# define IOTWEBCONF_ASYNC_MAX_CLIENTS 4
+#endif
+// -- AsyncWebServerWrapper rejects requests with longer head (request line
+// and headers), or longer non-form body. Form bodies are decoded on the fly
+// (see IOTWEBCONF_ASYNC_MAX_FORM_LENGTH).
+#ifndef IOTWEBCONF_ASYNC_MAX_HEAD_LENGTH
+# define IOTWEBCONF_ASYNC_MAX_HEAD_LENGTH 2048
+#endif
+#ifndef IOTWEBCONF_ASYNC_MAX_BODY_LENGTH
+# define IOTWEBCONF_ASYNC_MAX_BODY_LENGTH 4096
+#endif
+// -- AsyncWebServerWrapper rejects requests with a form (query and form body)
+// decoding to more arguments, or to longer names and values all together.
+#ifndef IOTWEBCONF_ASYNC_MAX_ARGS
+# define IOTWEBCONF_ASYNC_MAX_ARGS 64
+#endif
+#ifndef IOTWEBCONF_ASYNC_MAX_FORM_LENGTH
+# define IOTWEBCONF_ASYNC_MAX_FORM_LENGTH 4096
+#endif
+// -- AsyncWebServerWrapper drops a client not reading anything of the
+// response for this long (milliseconds).
+#ifndef IOTWEBCONF_ASYNC_CLIENT_TIMEOUT_MILLIS
+# define IOTWEBCONF_ASYNC_CLIENT_TIMEOUT_MILLIS 5000
+#endif
+// -- AsyncWebServerWrapper drops a client not sending the whole head of its
+// request within this time after connecting (milliseconds), or the whole
+// body within the other time after the head. So a client sending slowly
+// cannot hold a place for long.
+#ifndef IOTWEBCONF_ASYNC_HEAD_TIMEOUT_MILLIS
+# define IOTWEBCONF_ASYNC_HEAD_TIMEOUT_MILLIS 2000
+#endif
+#ifndef IOTWEBCONF_ASYNC_BODY_TIMEOUT_MILLIS
+# define IOTWEBCONF_ASYNC_BODY_TIMEOUT_MILLIS 5000
+#endif
+// -- While all places are taken, a client still sending its request head
+// after this long (milliseconds) is dropped for a new client.
+#ifndef IOTWEBCONF_ASYNC_BUSY_HEAD_TIMEOUT_MILLIS
+# define IOTWEBCONF_ASYNC_BUSY_HEAD_TIMEOUT_MILLIS 500
+#endif
+// -- AsyncWebServerWrapper answers "503 Service Unavailable" at once to a
+// request arriving while this many requests are waiting for their handlers
+// (handlers are called one at a time, so this limits the wait). Has no
+// effect unless below IOTWEBCONF_ASYNC_MAX_CLIENTS. Clients connecting while
+// all places are taken are answered the same way.
+#ifndef IOTWEBCONF_ASYNC_MAX_QUEUED
+# define IOTWEBCONF_ASYNC_MAX_QUEUED 2
+#endif
+// -- AsyncWebServerWrapper keeps a connection open after the response for
+// this long (milliseconds) waiting for the next request of the client.
+// 0 disables keep-alive. An idle connection is also dropped when a new
+// client would not fit otherwise.
+#ifndef IOTWEBCONF_ASYNC_KEEP_ALIVE_MILLIS
+# define IOTWEBCONF_ASYNC_KEEP_ALIVE_MILLIS 2000
+#endif
+// -- AsyncWebServerWrapper closes a connection after this many requests.
+#ifndef IOTWEBCONF_ASYNC_KEEP_ALIVE_MAX_REQUESTS
+# define IOTWEBCONF_ASYNC_KEEP_ALIVE_MAX_REQUESTS 32
+#endif
+// -- AsyncWebServerWrapper keeps at most this many bytes of a stream (see
+// WebRequestWrapper::openStream()) not yet read by the client. A client
+// lagging more is refused further writes.
+#ifndef IOTWEBCONF_ASYNC_STREAM_MAX_PENDING
+# define IOTWEBCONF_ASYNC_STREAM_MAX_PENDING 2048
+#endif
+// -- Count of clients receiving an event stream at the same time (see
+// IotWebConf::handleEvents()), for each of the two streams. Every viewer
+// keeps a connection open.
+#ifndef IOTWEBCONF_EVENT_MAX_VIEWERS
+# define IOTWEBCONF_EVENT_MAX_VIEWERS 2
+#endif
+// -- A comment is sent to the viewers of the event stream after this long
+// (milliseconds) of silence, so that the connection is kept open by
+// proxies, and clients gone are noticed.
+#ifndef IOTWEBCONF_EVENT_KEEP_ALIVE_MILLIS
+# define IOTWEBCONF_EVENT_KEEP_ALIVE_MILLIS 15000
+#endif
+// -- Browsers connect again to the event stream after this long
+// (milliseconds), when the stream was lost.
+#ifndef IOTWEBCONF_EVENT_RETRY_MILLIS
+# define IOTWEBCONF_EVENT_RETRY_MILLIS 3000
+#endif
+// -- Count of browsers kept logged in with session authentication (see
+// IotWebConf::setSessionAuth()). When all are taken, the least recently
+// used session is dropped.
+#ifndef IOTWEBCONF_SESSION_COUNT
+# define IOTWEBCONF_SESSION_COUNT 4
+#endif
+// -- A session not used for this long (milliseconds) expires, the browser
+// must authenticate again.
+#ifndef IOTWEBCONF_SESSION_TIMEOUT_MILLIS
+# define IOTWEBCONF_SESSION_TIMEOUT_MILLIS 600000
+#endif
+// -- Define this to have the standard WebServer ask for Digest instead of
+// Basic authentication, so that the password is never sent in clear text.
+// (AsyncWebServerWrapper supports Basic authentication only.)
+//#define IOTWEBCONF_AUTH_DIGEST
+// -- Time to live (seconds) of the answers of CaptiveDnsServer.
+#ifndef IOTWEBCONF_DNS_TTL
+# define IOTWEBCONF_DNS_TTL 60
+#endif
+// -- CaptiveDnsServer reads only this many bytes of a query, the question
+// must fit into it.
+#ifndef IOTWEBCONF_DNS_MAX_PACKET_SIZE
+# define IOTWEBCONF_DNS_MAX_PACKET_SIZE 512
+#endif
+
 #endif
\ No newline at end of file
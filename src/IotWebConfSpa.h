@@ -0,0 +1,189 @@
+/**
+ * IotWebConfSpa.h -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+// -- This file is generated by spa/build-spa.sh from spa/portal.html,
+//    do not edit it by hand!
+
+#ifndef IotWebConfSpa_h
+#define IotWebConfSpa_h
+
+#include <Arduino.h>
+
+const size_t IOTWEBCONF_SPA_GZ_LENGTH = 1971;
+const uint8_t IOTWEBCONF_SPA_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x58,
+  0x6d, 0x73, 0xdb, 0xb8, 0x11, 0xfe, 0xee, 0x5f, 0x81, 0xf0, 0x72, 0x01,
+  0x35, 0xb6, 0x20, 0x3b, 0xd7, 0xa4, 0x2d, 0x49, 0xe9, 0x26, 0x4d, 0x7d,
+  0xd3, 0xbb, 0x49, 0x9b, 0x4c, 0xed, 0x99, 0x4e, 0xc7, 0xe7, 0x0f, 0x10,
+  0x09, 0x51, 0x88, 0x48, 0x80, 0x21, 0x41, 0x59, 0xaa, 0x4e, 0xff, 0xbd,
+  0xbb, 0x00, 0xf8, 0x22, 0xdb, 0xc9, 0xb4, 0x9d, 0x7a, 0xc6, 0x96, 0xf0,
+  0xb2, 0xbb, 0xcf, 0xbe, 0x2f, 0x9c, 0xbc, 0xf8, 0xf3, 0xc7, 0xf7, 0xb7,
+  0xff, 0xfc, 0x74, 0x4d, 0xd6, 0xa6, 0x2c, 0x16, 0x09, 0xfe, 0x25, 0x05,
+  0x57, 0xf9, 0x3c, 0x10, 0x2a, 0x80, 0xb5, 0xe0, 0xd9, 0x22, 0x29, 0x85,
+  0xe1, 0x44, 0xf1, 0x52, 0xcc, 0x83, 0xad, 0x14, 0x0f, 0x95, 0xae, 0x4d,
+  0x40, 0x52, 0xad, 0x8c, 0x50, 0x66, 0x1e, 0x3c, 0xc8, 0xcc, 0xac, 0xe7,
+  0x99, 0xd8, 0xca, 0x54, 0x4c, 0xed, 0xe2, 0x82, 0x48, 0x25, 0x8d, 0xe4,
+  0xc5, 0xb4, 0x49, 0x79, 0x21, 0xe6, 0x57, 0x17, 0xa4, 0x6d, 0x44, 0x6d,
+  0x57, 0x7c, 0x09, 0x1b, 0x4a, 0x07, 0xb3, 0x45, 0x62, 0xa4, 0x29, 0xc4,
+  0xe2, 0xbd, 0x56, 0x2b, 0x99, 0x93, 0xeb, 0x9b, 0x4f, 0xc9, 0xcc, 0xed,
+  0x9c, 0x25, 0x8d, 0xd9, 0xc3, 0x27, 0xcb, 0xc4, 0x61, 0xc9, 0xd3, 0x4d,
+  0x5e, 0xeb, 0x56, 0x65, 0xd3, 0x54, 0x17, 0xba, 0x8e, 0xbe, 0x5b, 0xad,
+  0x38, 0xfc, 0xc4, 0x47, 0xc2, 0x44, 0x79, 0x58, 0x01, 0x88, 0x69, 0x23,
+  0xff, 0x25, 0xa2, 0x4b, 0xf6, 0x07, 0x51, 0xc6, 0xfe, 0xce, 0x72, 0x79,
+  0x09, 0x3f, 0x71, 0xc5, 0xb3, 0x4c, 0xaa, 0x7c, 0xba, 0xd4, 0xc6, 0xe8,
+  0x32, 0xba, 0xac, 0x76, 0x48, 0x96, 0x1e, 0x8c, 0xd8, 0x99, 0x29, 0x2f,
+  0x64, 0xae, 0x22, 0x92, 0x82, 0x0e, 0xa2, 0x86, 0xfd, 0x4c, 0x6e, 0x2f,
+  0xa4, 0xaa, 0x5a, 0x73, 0xd1, 0x88, 0x42, 0xa4, 0xe6, 0xe0, 0xa9, 0xa3,
+  0x37, 0x40, 0x36, 0xc8, 0xb9, 0x02, 0x29, 0x47, 0x62, 0x2f, 0x1e, 0xac,
+  0xb2, 0xd1, 0x1f, 0xdf, 0x7c, 0x0f, 0x3b, 0x9e, 0xc8, 0x6d, 0x5d, 0x5d,
+  0x5e, 0x7e, 0xef, 0x2f, 0xdd, 0x99, 0x7d, 0x25, 0xe6, 0xe9, 0x5a, 0xa4,
+  0x9b, 0xa5, 0xde, 0xdd, 0xfb, 0x0b, 0xbc, 0x35, 0x3a, 0xb6, 0xc6, 0x89,
+  0xae, 0xd8, 0x9b, 0xb8, 0xe4, 0x75, 0x2e, 0x15, 0x90, 0x59, 0x84, 0x4b,
+  0x9d, 0xed, 0x9f, 0xc3, 0x68, 0x41, 0xac, 0x78, 0x29, 0x8b, 0x7d, 0xb4,
+  0x15, 0x75, 0xc6, 0x15, 0x9a, 0x61, 0xd9, 0x82, 0x72, 0xea, 0xb0, 0xd4,
+  0x75, 0x26, 0xea, 0xe8, 0x32, 0x76, 0x5f, 0xa6, 0x35, 0xcf, 0x64, 0xdb,
+  0x80, 0x59, 0x7e, 0xa8, 0x01, 0xf1, 0x53, 0x33, 0x5e, 0xbd, 0x7d, 0x77,
+  0x75, 0xfd, 0xfb, 0xb8, 0x37, 0xea, 0x2a, 0x2e, 0xa4, 0x12, 0xd3, 0xb5,
+  0x90, 0xf9, 0xda, 0x44, 0xaf, 0xd9, 0xef, 0x90, 0x6c, 0xa4, 0x36, 0x7b,
+  0x8d, 0x1b, 0x83, 0x7a, 0x20, 0x79, 0x25, 0x45, 0x91, 0x35, 0xc2, 0x1c,
+  0x9e, 0x15, 0xe9, 0x75, 0x22, 0xde, 0xea, 0x6b, 0x09, 0xde, 0xcc, 0x64,
+  0x53, 0x15, 0x7c, 0x1f, 0x11, 0xa5, 0x95, 0x88, 0x8f, 0xc9, 0xcc, 0x39,
+  0xfa, 0x2c, 0x99, 0xb9, 0x40, 0x43, 0xcd, 0x17, 0x09, 0x78, 0x82, 0xd8,
+  0x83, 0x39, 0x1d, 0x59, 0xa1, 0x10, 0x2b, 0x13, 0x77, 0x0c, 0xa4, 0xb2,
+  0x68, 0x97, 0x85, 0x4e, 0x37, 0x71, 0x29, 0x95, 0x8b, 0xbb, 0xe8, 0xf5,
+  0x5b, 0x94, 0x46, 0x81, 0xe1, 0x4a, 0xd7, 0x25, 0x91, 0xd9, 0x9c, 0xae,
+  0xe8, 0xe2, 0x83, 0xe6, 0xe8, 0x48, 0xc6, 0x58, 0x32, 0xc3, 0x7d, 0x27,
+  0x01, 0x0f, 0x1b, 0xba, 0x48, 0x66, 0xb0, 0x18, 0x76, 0xea, 0x7e, 0xc7,
+  0xfe, 0x85, 0x50, 0x4c, 0x6b, 0x59, 0x99, 0xc5, 0xd9, 0x6c, 0x46, 0xa6,
+  0x53, 0xf2, 0xb3, 0x36, 0xff, 0x10, 0x4b, 0x0c, 0x59, 0x92, 0x16, 0x12,
+  0xdc, 0x42, 0x6a, 0xa1, 0x40, 0x77, 0x91, 0x61, 0x3e, 0x60, 0x1c, 0x63,
+  0x72, 0xf0, 0x82, 0x91, 0xdb, 0xb5, 0x20, 0x15, 0xcf, 0x05, 0x91, 0xcd,
+  0x70, 0x67, 0x55, 0xeb, 0x12, 0x39, 0xc1, 0x8f, 0x81, 0xf3, 0x06, 0xc2,
+  0xa2, 0xe4, 0xa4, 0xaa, 0xf5, 0x16, 0xac, 0x93, 0x91, 0xe5, 0xde, 0x6e,
+  0xbb, 0x54, 0x22, 0xdc, 0x90, 0x20, 0x31, 0x6b, 0xa0, 0x6f, 0xeb, 0x62,
+  0xf1, 0xa3, 0xbb, 0x1c, 0x5c, 0x10, 0xae, 0x32, 0xb2, 0xe5, 0x45, 0x2b,
+  0x1a, 0xcf, 0x8a, 0xd7, 0x20, 0x4a, 0x37, 0x06, 0x39, 0x80, 0x9f, 0x09,
+  0x6f, 0xc8, 0x2f, 0x37, 0x1f, 0xff, 0x46, 0x8c, 0x76, 0x52, 0x20, 0x71,
+  0x91, 0x05, 0x3b, 0xdb, 0xf2, 0x9a, 0xb4, 0x64, 0x4e, 0xc0, 0x6a, 0xdc,
+  0x48, 0xad, 0x58, 0xc5, 0xcd, 0x1a, 0xf3, 0xfa, 0x82, 0xa4, 0x6b, 0x2e,
+  0x55, 0x03, 0x67, 0x77, 0xf7, 0xf1, 0xd9, 0xaa, 0x55, 0x29, 0x9e, 0x93,
+  0x97, 0xa1, 0xcc, 0x26, 0xe4, 0x00, 0x0a, 0x98, 0xb6, 0x56, 0x24, 0xd3,
+  0x69, 0x5b, 0x82, 0xd2, 0x2c, 0x17, 0xe6, 0xba, 0x10, 0xf8, 0xf5, 0x4f,
+  0xfb, 0x9f, 0x33, 0xbc, 0x14, 0x93, 0xe3, 0x40, 0x56, 0x3d, 0x78, 0x3a,
+  0x14, 0xb8, 0x03, 0xa6, 0x2f, 0xdd, 0x95, 0x1d, 0xc3, 0x64, 0x80, 0x75,
+  0xd8, 0x7d, 0x9b, 0xcf, 0x09, 0xad, 0x78, 0xd3, 0x3c, 0x40, 0x04, 0xd1,
+  0x09, 0xf9, 0x91, 0x58, 0x8f, 0x53, 0x12, 0x8d, 0xb6, 0x4f, 0x58, 0x37,
+  0x6b, 0xdd, 0x31, 0xb7, 0x4c, 0x59, 0x5a, 0xc0, 0xbd, 0x0f, 0xb2, 0x31,
+  0x0c, 0x82, 0x4e, 0x6f, 0x45, 0x48, 0x31, 0xd2, 0xe8, 0x29, 0x20, 0xdc,
+  0xfa, 0x0a, 0x15, 0x24, 0xf9, 0xb3, 0x24, 0x28, 0xe8, 0xa7, 0xc6, 0x11,
+  0x9d, 0x91, 0x5e, 0x6e, 0xdc, 0xf1, 0x22, 0xe7, 0x84, 0x2e, 0x91, 0xe6,
+  0xa5, 0x5f, 0x6c, 0xe9, 0x84, 0x59, 0xb7, 0x80, 0x7e, 0x94, 0x03, 0x93,
+  0xad, 0x00, 0xe8, 0x68, 0x01, 0xe5, 0x2d, 0x80, 0xb7, 0x14, 0xaa, 0x37,
+  0x89, 0x81, 0xa3, 0x5c, 0x91, 0x50, 0x91, 0x57, 0xaf, 0xe0, 0x48, 0x79,
+  0xc2, 0x53, 0x2e, 0xc0, 0x46, 0x2a, 0xcf, 0x08, 0x91, 0x5b, 0x08, 0xa3,
+  0xab, 0x4b, 0x87, 0xf8, 0x91, 0x9a, 0x23, 0xcc, 0x9d, 0xd6, 0x71, 0x87,
+  0xfe, 0xdb, 0x98, 0x7b, 0x61, 0xff, 0x57, 0xd4, 0x16, 0xc4, 0x37, 0x51,
+  0x8b, 0xb0, 0x71, 0x78, 0x7d, 0x94, 0xdd, 0x98, 0x1a, 0xb2, 0x35, 0x6c,
+  0x90, 0x97, 0x6a, 0x8b, 0x02, 0xa3, 0x02, 0x23, 0xa2, 0x99, 0x80, 0x8b,
+  0x21, 0xfb, 0x53, 0x11, 0xce, 0xee, 0x5e, 0x25, 0x0b, 0x1a, 0xdc, 0xcf,
+  0xf2, 0x0b, 0xd2, 0xf1, 0x09, 0xd3, 0x51, 0xa4, 0xd2, 0x57, 0xdf, 0x51,
+  0x90, 0x96, 0x32, 0x88, 0xeb, 0xfa, 0xbd, 0xce, 0xc4, 0x3b, 0x13, 0x5e,
+  0x4e, 0x50, 0x7e, 0x8c, 0xf1, 0x04, 0xaa, 0x8c, 0x00, 0x48, 0x23, 0xca,
+  0x70, 0xe7, 0x30, 0xa0, 0x7e, 0x3b, 0x96, 0x93, 0x17, 0x4e, 0xf6, 0x88,
+  0x25, 0x96, 0xcf, 0x0a, 0xae, 0x21, 0x7a, 0x62, 0x2d, 0xc4, 0xc1, 0x42,
+  0x81, 0xad, 0x1a, 0x01, 0x70, 0xde, 0x31, 0x09, 0x7f, 0x03, 0xea, 0x1a,
+  0xe5, 0xe9, 0x16, 0x2e, 0x80, 0x6d, 0x4a, 0x7e, 0xfb, 0x0d, 0x74, 0xb1,
+  0x86, 0x44, 0x06, 0x6b, 0x64, 0xd0, 0x97, 0x9e, 0x11, 0x45, 0x06, 0x55,
+  0x08, 0x3a, 0xa5, 0x28, 0x08, 0xd4, 0xab, 0x53, 0x5e, 0x0b, 0x5c, 0x08,
+  0x60, 0x56, 0xa0, 0x3a, 0x41, 0x32, 0xb3, 0xf7, 0x16, 0x41, 0xdc, 0x83,
+  0x37, 0xd6, 0x09, 0xae, 0x1f, 0x51, 0xa7, 0x15, 0xc4, 0x02, 0x39, 0x87,
+  0xcd, 0xc4, 0xef, 0x02, 0x25, 0x47, 0x63, 0x2c, 0x68, 0x6c, 0x4f, 0x77,
+  0x4c, 0x33, 0x90, 0x74, 0xcd, 0xd3, 0x75, 0xd8, 0xdb, 0x53, 0x77, 0xb4,
+  0x9e, 0x3a, 0x48, 0x74, 0x65, 0xed, 0x65, 0x7d, 0xe9, 0x50, 0x89, 0x50,
+  0xdf, 0x5d, 0xde, 0x5b, 0x24, 0x76, 0x6d, 0x97, 0x28, 0x7f, 0xc7, 0xb6,
+  0xe8, 0x37, 0xdf, 0x16, 0x45, 0x66, 0x53, 0x9a, 0x4e, 0x9c, 0x50, 0x4f,
+  0x78, 0x65, 0x09, 0x69, 0x32, 0x73, 0x7c, 0x3b, 0x30, 0xc7, 0x49, 0x3c,
+  0x86, 0x3c, 0x73, 0x2c, 0xdc, 0xe9, 0x91, 0x88, 0xa2, 0x11, 0x1e, 0x97,
+  0x53, 0xf7, 0x0b, 0xfa, 0x88, 0xdb, 0xbb, 0xe0, 0xaa, 0x2f, 0xad, 0x84,
+  0x42, 0x4b, 0x9d, 0x93, 0x08, 0xb9, 0xa3, 0x65, 0x54, 0xf2, 0x5d, 0x21,
+  0x54, 0x6e, 0xd6, 0xf4, 0x82, 0xd0, 0x4d, 0x04, 0xdd, 0x62, 0x58, 0xee,
+  0x22, 0x28, 0x81, 0xd0, 0x5b, 0x15, 0x2e, 0xe0, 0xc4, 0x7e, 0xf0, 0x1d,
+  0x7e, 0x40, 0x3d, 0xad, 0xf0, 0xb3, 0x8a, 0x6c, 0xcc, 0xad, 0x75, 0x01,
+  0x35, 0x9c, 0xde, 0x3f, 0xb5, 0xd3, 0x66, 0xb0, 0xd3, 0x06, 0x1c, 0xba,
+  0x61, 0xd0, 0xa2, 0xa4, 0x09, 0x69, 0x44, 0xbd, 0x22, 0x1e, 0xe9, 0xdd,
+  0x06, 0x6c, 0x73, 0x3f, 0x8e, 0x2c, 0x8f, 0x1a, 0xed, 0x11, 0x6e, 0xc0,
+  0x1c, 0x18, 0x1e, 0x9b, 0xce, 0x9e, 0x9d, 0x81, 0x3d, 0x9d, 0xb7, 0x71,
+  0xa7, 0xd8, 0x89, 0x91, 0x82, 0xc4, 0x8e, 0x1a, 0xc4, 0x8e, 0x1a, 0x3e,
+  0x5a, 0x4c, 0xef, 0x13, 0xee, 0x82, 0xcf, 0x85, 0x45, 0x37, 0x88, 0x50,
+  0xf0, 0x4e, 0xd8, 0x39, 0xc9, 0x6e, 0x0e, 0x3e, 0x8a, 0x20, 0x5e, 0x4f,
+  0x7c, 0x0c, 0xf7, 0xbc, 0x78, 0xeb, 0xb0, 0x99, 0xf7, 0xc5, 0x90, 0xb2,
+  0x6b, 0x1b, 0x8a, 0x18, 0xc8, 0xb6, 0xb0, 0xce, 0xa9, 0x28, 0xe9, 0xe3,
+  0x98, 0x16, 0xa7, 0x9d, 0x35, 0x38, 0x49, 0x41, 0x97, 0x5c, 0xb9, 0xb3,
+  0x24, 0xa6, 0x86, 0x04, 0x4b, 0xe6, 0x0c, 0xd2, 0x1b, 0x73, 0x84, 0x82,
+  0x1f, 0x5c, 0x8c, 0xf0, 0x02, 0xbb, 0x47, 0xce, 0x78, 0x6f, 0xc6, 0x2e,
+  0xee, 0xbb, 0xf3, 0x93, 0x80, 0x0f, 0x12, 0x37, 0x1d, 0xf5, 0x58, 0x2c,
+  0x92, 0x25, 0xed, 0x60, 0xda, 0x90, 0x45, 0x6e, 0x60, 0x05, 0xdb, 0x03,
+  0xfa, 0x28, 0x85, 0xa4, 0xd5, 0x0a, 0x5a, 0x7c, 0xba, 0x99, 0xff, 0x1a,
+  0xf8, 0x5e, 0x30, 0x70, 0xc0, 0x1a, 0xe6, 0x55, 0x5f, 0x71, 0x08, 0xc8,
+  0xf8, 0xd7, 0x60, 0x71, 0x4e, 0x9c, 0xb1, 0x72, 0x97, 0x99, 0x10, 0xb8,
+  0x4e, 0xf6, 0x60, 0x2c, 0x0f, 0xa9, 0x1b, 0x9b, 0x4e, 0x41, 0x9d, 0x62,
+  0xea, 0xb5, 0x85, 0x4a, 0xfb, 0xe2, 0x2b, 0x00, 0xa1, 0x44, 0x88, 0x1c,
+  0x26, 0x8b, 0xc5, 0x63, 0xb9, 0x7e, 0x9b, 0xfe, 0x67, 0xa6, 0x19, 0xd4,
+  0xf4, 0xed, 0xe3, 0xdb, 0x6a, 0xfe, 0xdd, 0x76, 0x59, 0x62, 0xe7, 0x12,
+  0x50, 0xa2, 0xd7, 0x32, 0x78, 0x26, 0x1e, 0x4f, 0x14, 0xdc, 0x8e, 0x2b,
+  0x63, 0xb7, 0xe3, 0x22, 0x16, 0x04, 0x67, 0x42, 0xd1, 0x71, 0xd0, 0x75,
+  0x5e, 0xf1, 0x9d, 0x04, 0xd5, 0x1e, 0xb5, 0x15, 0xc4, 0x36, 0x73, 0x22,
+  0xd1, 0xb0, 0x39, 0x93, 0x4f, 0xd3, 0x72, 0x67, 0xbb, 0x0f, 0xc2, 0xf1,
+  0xf5, 0x3d, 0xf6, 0x49, 0x83, 0x26, 0xc9, 0x99, 0x7a, 0x64, 0x8d, 0x71,
+  0x06, 0x75, 0x78, 0x4e, 0xf0, 0xdb, 0x1e, 0x78, 0x9a, 0x17, 0x96, 0xcb,
+  0x08, 0x0b, 0xf1, 0x63, 0x14, 0xab, 0xda, 0x66, 0x0d, 0xd1, 0xfc, 0x4c,
+  0x96, 0x80, 0x7b, 0x3a, 0xff, 0xa3, 0x83, 0x20, 0x05, 0x84, 0x01, 0xd4,
+  0x2d, 0x1e, 0xf9, 0x11, 0x0f, 0x7a, 0x29, 0x8c, 0x6d, 0x6a, 0xd0, 0xa4,
+  0x1e, 0x75, 0xa1, 0x9a, 0x7d, 0x6e, 0x60, 0xcb, 0x2a, 0xf3, 0xe8, 0x5a,
+  0x33, 0x64, 0x8f, 0x4b, 0x1a, 0x14, 0xdf, 0xfc, 0x57, 0xa6, 0x79, 0x19,
+  0xc2, 0xbc, 0x3c, 0x61, 0x52, 0x29, 0x51, 0xff, 0xe5, 0xf6, 0xaf, 0x1f,
+  0x80, 0x8d, 0x4b, 0x6d, 0x1f, 0x2b, 0xce, 0x3c, 0x4d, 0xbb, 0x2c, 0x25,
+  0xd8, 0xc2, 0xcf, 0xe8, 0x6e, 0xd0, 0x9f, 0x1a, 0x5d, 0x45, 0xe4, 0xca,
+  0xcd, 0xdf, 0xef, 0xaa, 0xaa, 0xd8, 0x9f, 0x86, 0x86, 0xb7, 0xcc, 0x13,
+  0x2c, 0x98, 0xf3, 0xd6, 0x25, 0x18, 0xe6, 0xfd, 0xc0, 0x00, 0x96, 0x1d,
+  0x86, 0x85, 0x01, 0x5c, 0xfd, 0x08, 0x5c, 0x30, 0x7e, 0x2b, 0x0c, 0x8f,
+  0x15, 0xc2, 0xde, 0xc2, 0x03, 0x84, 0x2e, 0x7e, 0x92, 0x75, 0xf9, 0x80,
+  0xd3, 0xb1, 0x9f, 0xcd, 0xe1, 0xd1, 0xd4, 0x60, 0xb5, 0xf1, 0xee, 0x6b,
+  0x58, 0xea, 0xeb, 0xda, 0x50, 0x92, 0x40, 0x92, 0x37, 0x82, 0x56, 0x4e,
+  0x4f, 0x10, 0xd3, 0x83, 0x1d, 0x2c, 0x9c, 0xc1, 0xf6, 0xe1, 0x08, 0xd3,
+  0x87, 0x9d, 0x92, 0x2c, 0x81, 0x70, 0x13, 0x71, 0x83, 0x58, 0x41, 0x4d,
+  0x12, 0xe2, 0x3d, 0xec, 0x08, 0x97, 0x31, 0x7c, 0x24, 0x64, 0xc5, 0x5c,
+  0xdf, 0x81, 0xd5, 0xf9, 0x79, 0x17, 0x7d, 0xdd, 0x84, 0xbc, 0xba, 0xdb,
+  0xdc, 0xc7, 0xa3, 0xae, 0x86, 0xa9, 0x82, 0xd6, 0xc8, 0xee, 0xdc, 0xf7,
+  0xfb, 0x93, 0xa9, 0x79, 0x54, 0xc7, 0x71, 0x68, 0x86, 0xc9, 0xc2, 0x55,
+  0x70, 0x48, 0x93, 0x9d, 0x1b, 0xb5, 0x5c, 0x9f, 0xc0, 0x5f, 0x1f, 0x60,
+  0x17, 0xc0, 0x0c, 0xde, 0xf1, 0x6b, 0x9d, 0x41, 0x2a, 0x7d, 0xfa, 0x78,
+  0x73, 0x0b, 0x35, 0x15, 0x1f, 0x5d, 0x60, 0x92, 0x08, 0x8e, 0xe8, 0x7b,
+  0xf7, 0x9c, 0x9f, 0xde, 0x82, 0x04, 0x0a, 0x57, 0x38, 0xb8, 0x50, 0xba,
+  0x67, 0xc2, 0x0c, 0x43, 0x8e, 0x12, 0xd0, 0x16, 0xdf, 0x67, 0x91, 0x7d,
+  0x5c, 0xb0, 0xc6, 0x4e, 0x69, 0x72, 0xb5, 0x0f, 0x61, 0xda, 0x3c, 0x4e,
+  0x2c, 0xf4, 0xff, 0x2d, 0x6e, 0x3f, 0x0f, 0xfd, 0xb3, 0x7f, 0x60, 0x7c,
+  0x69, 0x45, 0xbd, 0xbf, 0xb1, 0x8d, 0x5f, 0xd7, 0xef, 0x8a, 0x22, 0xa4,
+  0x0c, 0x27, 0xf4, 0xaf, 0x84, 0xf2, 0xee, 0x99, 0x57, 0x80, 0x1f, 0xe8,
+  0xfb, 0x16, 0xfc, 0x2d, 0xd6, 0xd0, 0xad, 0xbe, 0xce, 0x1a, 0x1f, 0x24,
+  0xde, 0x38, 0x2e, 0xab, 0x46, 0x4c, 0x7b, 0x37, 0xc3, 0x98, 0x2c, 0x15,
+  0x09, 0x3f, 0x33, 0x51, 0xd7, 0xba, 0x6e, 0xb0, 0x91, 0x1f, 0x8e, 0x93,
+  0x41, 0x31, 0xd2, 0x8f, 0xd2, 0xf0, 0xcc, 0x79, 0xfc, 0xfa, 0xb0, 0x50,
+  0x9f, 0x5c, 0x44, 0x75, 0x4f, 0x65, 0x77, 0xdc, 0xef, 0x64, 0x76, 0xdf,
+  0xdd, 0x3f, 0x9e, 0x75, 0x54, 0xf0, 0x98, 0x7d, 0x4a, 0xa0, 0x37, 0x58,
+  0x44, 0xdd, 0xbf, 0x58, 0xda, 0x9a, 0xbb, 0x97, 0x0d, 0xdf, 0x8a, 0x8c,
+  0x61, 0x49, 0xed, 0xf0, 0x8e, 0xc6, 0xd2, 0x6e, 0xb2, 0x38, 0x29, 0xfb,
+  0x67, 0xc7, 0x18, 0x9e, 0xe8, 0xfe, 0x25, 0x0c, 0x69, 0x6d, 0x5f, 0xe9,
+  0x33, 0xfb, 0x1f, 0xa3, 0xb3, 0x7f, 0x03, 0x3c, 0xa8, 0xc8, 0xe6, 0x42,
+  0x12, 0x00, 0x00
+};
+
+#endif
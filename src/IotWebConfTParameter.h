@@ -16,15 +16,9 @@
 // TODO: This file is a mess. Help wanted to organize thing!
 
 #include <IotWebConfParameter.h>
+#include <IotWebConfNumber.h>
 #include <Arduino.h>
 #include <IPAddress.h>
-#include <errno.h>
-
-// At least in PlatformIO, strtoimax/strtoumax are defined, but not implemented.
-#if 1
-#define strtoimax strtoll
-#define strtoumax strtoull
-#endif
 
 namespace iotwebconf
 {
@@ -44,6 +38,29 @@ public:
         this->update(newValue);
       }
   }
+  virtual bool validate(WebRequestWrapper* webRequestWrapper) override
+  {
+      if (webRequestWrapper->hasArg(this->getId()))
+      {
+        String newValue = webRequestWrapper->arg(this->getId());
+        const char* message = this->checkConstraints(newValue.c_str());
+        if (message != NULL)
+        {
+          this->validationFailed(message);
+          return false;
+        }
+        if (!this->update(newValue, true))
+        {
+          this->validationFailed("Invalid value.");
+          return false;
+        }
+      }
+      else
+      {
+        return this->validateMissing(webRequestWrapper);
+      }
+      return true;
+  }
   void debugTo(Stream* out) override
   {
     out->print("'");
@@ -52,12 +69,49 @@ public:
     out->print(this->toString());
     out->println("'");
   }
+  void renderJson(JsonWriter* jsonWriter) override
+  {
+    this->renderJsonValue(jsonWriter, this->getId());
+  }
 
 protected:
   ConfigItemBridge(const char* id) : ConfigItem(id) { }
   virtual int getInputLength() { return 0; };
+  /**
+   * Writes the value as JSON member with the key provided.
+   */
+  virtual void renderJsonValue(JsonWriter* jsonWriter, const char* key)
+  {
+    jsonWriter->writeString(key, this->toString().c_str());
+  }
   virtual bool update(String newValue, bool validateOnly = false) = 0;
   virtual String toString() = 0;
+  /**
+   * Called when the posted value was rejected by the validation.
+   */
+  virtual void validationFailed(const char* message) { };
+  /**
+   * Check the declared constraints of the value (see InputConstraints).
+   *   Returns an error message, or NULL if the value is accepted.
+   */
+  virtual const char* checkConstraints(const char* value) { return NULL; };
+  /**
+   * A value left out of a full (not partial) post is checked as empty, so
+   *   that a required value can not be skipped.
+   */
+  bool validateMissing(WebRequestWrapper* webRequestWrapper)
+  {
+    if (this->visible && !webRequestWrapper->isPartial())
+    {
+      const char* message = this->checkConstraints("");
+      if (message != NULL)
+      {
+        this->validationFailed(message);
+        return false;
+      }
+    }
+    return true;
+  }
 };
 
 ///////////////////////////////////////////////////////////////////////////
@@ -105,9 +159,10 @@ public:
 
 protected:
   virtual bool update(String newValue, bool validateOnly) override {
-    if (!validateOnly)
+    if (!validateOnly && !this->_value.equals(newValue))
     {
       this->_value = newValue;
+      this->markChanged();
     }
     return true;
   }
@@ -130,9 +185,53 @@ protected:
   {
     strncpy(this->_value, this->_defaultValue, len);
   }
+  /**
+   * The posted value is copied from the request without creating a String.
+   */
+  virtual void update(WebRequestWrapper* webRequestWrapper) override
+  {
+    if (webRequestWrapper->hasArg(this->getId()))
+    {
+      char newValue[len];
+      size_t length = webRequestWrapper->readArg(this->getId(), newValue, len);
+      this->update(newValue, length, false);
+    }
+  }
+  virtual bool validate(WebRequestWrapper* webRequestWrapper) override
+  {
+    if (webRequestWrapper->hasArg(this->getId()))
+    {
+      char newValue[len];
+      size_t length = webRequestWrapper->readArg(this->getId(), newValue, len);
+      const char* message = this->checkConstraints(newValue);
+      if ((length < len) && (message != NULL))
+      {
+        this->validationFailed(message);
+        return false;
+      }
+      if (!this->update(newValue, length, true))
+      {
+        this->validationFailed("Value is too long.");
+        return false;
+      }
+    }
+    else
+    {
+      return this->validateMissing(webRequestWrapper);
+    }
+    return true;
+  }
   virtual bool update(String newValue, bool validateOnly) override
   {
-    if (newValue.length() + 1 > len)
+    return this->update(newValue.c_str(), newValue.length(), validateOnly);
+  }
+  /**
+   * @length - The length of the whole value, that might be longer than
+   *   what newValue holds. In that case the value is not accepted.
+   */
+  virtual bool update(const char* newValue, size_t length, bool validateOnly)
+  {
+    if (length + 1 > len)
     {
       return false;
     }
@@ -143,7 +242,11 @@ protected:
       Serial.print(": ");
       Serial.println(newValue);
 #endif
-      strncpy(this->_value, newValue.c_str(), len);
+      if (strncmp(this->_value, newValue, len) != 0)
+      {
+        strncpy(this->_value, newValue, len);
+        this->markChanged();
+      }
     }
     return true;
   }
@@ -184,23 +287,88 @@ using DataType<ValueType>::DataType;
   void setMin(ValueType val) { this->_min = val; this->_minDefined = true; }
 
 protected:
+  /**
+   * Value is formatted on the stack, not into a String.
+   */
+  virtual void renderJsonValue(JsonWriter* jsonWriter, const char* key) override
+  {
+    char text[IOTWEBCONF_NUMBER_TEXT_SIZE];
+    this->formatValue(this->_value, text, sizeof(text));
+    jsonWriter->writeNumber(key, text);
+  }
+  virtual String toString() override
+  {
+    char text[IOTWEBCONF_NUMBER_TEXT_SIZE];
+    this->formatValue(this->_value, text, sizeof(text));
+    return String(text);
+  }
+
   virtual void applyDefaultValue() override
   {
     this->_value = this->_defaultValue;
   }
 
+  /**
+   * The posted value is parsed from the request without creating a String.
+   */
+  virtual void update(WebRequestWrapper* webRequestWrapper) override
+  {
+    if (webRequestWrapper->hasArg(this->getId()))
+    {
+      char newValue[IOTWEBCONF_NUMBER_TEXT_SIZE];
+      size_t length = webRequestWrapper->readArg(
+        this->getId(), newValue, sizeof(newValue));
+      if (length < sizeof(newValue))
+      {
+        this->update(newValue, length, false);
+      }
+    }
+  }
+  virtual bool validate(WebRequestWrapper* webRequestWrapper) override
+  {
+    if (webRequestWrapper->hasArg(this->getId()))
+    {
+      char newValue[IOTWEBCONF_NUMBER_TEXT_SIZE];
+      size_t length = webRequestWrapper->readArg(
+        this->getId(), newValue, sizeof(newValue));
+      const char* message = this->checkConstraints(newValue);
+      if ((length < sizeof(newValue)) && (message != NULL))
+      {
+        this->validationFailed(message);
+        return false;
+      }
+      if ((length >= sizeof(newValue)) || !this->update(newValue, length, true))
+      {
+        this->validationFailed("Invalid value.");
+        return false;
+      }
+    }
+    else
+    {
+      return this->validateMissing(webRequestWrapper);
+    }
+    return true;
+  }
   virtual bool update(String newValue, bool validateOnly) override
   {
-    errno = 0;
-    ValueType val = fromString(newValue);
-    if ((errno == ERANGE)
+    return this->update(newValue.c_str(), newValue.length(), validateOnly);
+  }
+  /**
+   * Text not being a value of the type (or being out of its range), or a
+   *   value out of the min/max limits is not accepted.
+   */
+  virtual bool update(const char* newValue, size_t length, bool validateOnly)
+  {
+    ValueType val;
+    if (!this->parseValue(newValue, length, &val)
       || (this->_minDefined && (val < this->_min))
       || (this->_maxDefined && (val > this->_max)))
     {
 #ifdef IOTWEBCONF_DEBUG_TO_SERIAL
       Serial.print(this->getId());
       Serial.print(" value not accepted: ");
-      Serial.println(val);
+      Serial.write((const uint8_t*)newValue, length);
+      Serial.println();
 #endif
       return false;
     }
@@ -209,9 +377,14 @@ protected:
 #ifdef IOTWEBCONF_DEBUG_TO_SERIAL
       Serial.print(this->getId());
       Serial.print(": ");
-      Serial.println((ValueType)val);
+      Serial.write((const uint8_t*)newValue, length);
+      Serial.println();
 #endif
-      this->_value = (ValueType) val;
+      if (this->_value != val)
+      {
+        this->_value = val;
+        this->markChanged();
+      }
     }
     return true;
   }
@@ -235,7 +408,16 @@ protected:
     ValueType* valuePointer = reinterpret_cast<ValueType*>(buf);
     this->_value = *valuePointer;
   }
-  virtual ValueType fromString(String stringValue) = 0;
+  /**
+   * Parse the text (not zero terminated, length bytes) into value. Returns
+   *   false for text not being a value of the type. (See IotWebConfNumber.h.)
+   */
+  virtual bool parseValue(const char* text, size_t length, ValueType* value) = 0;
+  /**
+   * Write the value as zero terminated text into the buffer. Returns the
+   *   length of the text, or 0 if it did not fit.
+   */
+  virtual size_t formatValue(ValueType value, char* buffer, size_t size) = 0;
 
   ValueType getMax() { return this->_max; }
   ValueType getMin() { return this->_min; }
@@ -261,9 +443,29 @@ using DataType<ValueType>::DataType;
     PrimitiveDataType<ValueType>::PrimitiveDataType(id, defaultValue) { };
 
 protected:
-  virtual ValueType fromString(String stringValue)
+  virtual bool parseValue(const char* text, size_t length, ValueType* value) override
+  {
+    return parseNumber(text, length, value, base);
+  }
+  virtual size_t formatValue(ValueType value, char* buffer, size_t size) override
+  {
+    return formatSigned(value, buffer, size, base);
+  }
+  /**
+   * JSON knows decimal numbers only.
+   */
+  virtual void renderJsonValue(JsonWriter* jsonWriter, const char* key) override
   {
-    return (ValueType)strtoimax(stringValue.c_str(), NULL, base);
+    char text[IOTWEBCONF_NUMBER_TEXT_SIZE];
+    this->formatValue(this->_value, text, sizeof(text));
+    if (base == 10)
+    {
+      jsonWriter->writeNumber(key, text);
+    }
+    else
+    {
+      jsonWriter->writeString(key, text);
+    }
   }
 };
 
@@ -277,9 +479,29 @@ using DataType<ValueType>::DataType;
     PrimitiveDataType<ValueType>::PrimitiveDataType(id, defaultValue) { };
 
 protected:
-  virtual ValueType fromString(String stringValue)
+  virtual bool parseValue(const char* text, size_t length, ValueType* value) override
+  {
+    return parseNumber(text, length, value, base);
+  }
+  virtual size_t formatValue(ValueType value, char* buffer, size_t size) override
   {
-    return (ValueType)strtoumax(stringValue.c_str(), NULL, base);
+    return formatUnsigned(value, buffer, size, base);
+  }
+  /**
+   * JSON knows decimal numbers only.
+   */
+  virtual void renderJsonValue(JsonWriter* jsonWriter, const char* key) override
+  {
+    char text[IOTWEBCONF_NUMBER_TEXT_SIZE];
+    this->formatValue(this->_value, text, sizeof(text));
+    if (base == 10)
+    {
+      jsonWriter->writeNumber(key, text);
+    }
+    else
+    {
+      jsonWriter->writeString(key, text);
+    }
   }
 };
 
@@ -292,9 +514,18 @@ using DataType<bool>::DataType;
     PrimitiveDataType<bool>::PrimitiveDataType(id, defaultValue) { };
 
 protected:
-  virtual bool fromString(String stringValue)
+  virtual void renderJsonValue(JsonWriter* jsonWriter, const char* key) override
+  {
+    jsonWriter->writeBool(key, this->_value);
+  }
+
+  virtual bool parseValue(const char* text, size_t length, bool* value) override
+  {
+    return parseBool(text, length, value);
+  }
+  virtual size_t formatValue(bool value, char* buffer, size_t size) override
   {
-    return stringValue.c_str()[0] == 1;
+    return formatBool(value, buffer, size);
   }
 };
 
@@ -307,9 +538,13 @@ using DataType<float>::DataType;
     PrimitiveDataType<float>::PrimitiveDataType(id, defaultValue) { };
 
 protected:
-  virtual float fromString(String stringValue)
+  virtual bool parseValue(const char* text, size_t length, float* value) override
   {
-    return atof(stringValue.c_str());
+    return parseFloat(text, length, value);
+  }
+  virtual size_t formatValue(float value, char* buffer, size_t size) override
+  {
+    return formatFloat(value, buffer, size);
   }
 };
 
@@ -322,9 +557,13 @@ using DataType<double>::DataType;
     PrimitiveDataType<double>::PrimitiveDataType(id, defaultValue) { };
 
 protected:
-  virtual double fromString(String stringValue)
+  virtual bool parseValue(const char* text, size_t length, double* value) override
+  {
+    return parseDouble(text, length, value);
+  }
+  virtual size_t formatValue(double value, char* buffer, size_t size) override
   {
-    return strtod(stringValue.c_str(), NULL);
+    return formatDouble(value, buffer, size);
   }
 };
 
@@ -335,20 +574,72 @@ class IpDataType : public DataType<IPAddress>
 using DataType<IPAddress>::DataType;
 
 protected:
-  virtual bool update(String newValue, bool validateOnly) override
+  virtual void update(WebRequestWrapper* webRequestWrapper) override
   {
-    if (validateOnly)
+    if (webRequestWrapper->hasArg(this->getId()))
     {
-      IPAddress ip;
-      return ip.fromString(newValue);
+      char newValue[IOTWEBCONF_NUMBER_TEXT_SIZE];
+      size_t length = webRequestWrapper->readArg(
+        this->getId(), newValue, sizeof(newValue));
+      this->update(newValue, length, false);
+    }
+  }
+  virtual bool validate(WebRequestWrapper* webRequestWrapper) override
+  {
+    if (webRequestWrapper->hasArg(this->getId()))
+    {
+      char newValue[IOTWEBCONF_NUMBER_TEXT_SIZE];
+      size_t length = webRequestWrapper->readArg(
+        this->getId(), newValue, sizeof(newValue));
+      const char* message = this->checkConstraints(newValue);
+      if ((length < sizeof(newValue)) && (message != NULL))
+      {
+        this->validationFailed(message);
+        return false;
+      }
+      if (!this->update(newValue, length, true))
+      {
+        this->validationFailed("Invalid value.");
+        return false;
+      }
     }
     else
     {
-      return this->_value.fromString(newValue);
+      return this->validateMissing(webRequestWrapper);
     }
+    return true;
+  }
+  virtual bool update(String newValue, bool validateOnly) override
+  {
+    return this->update(newValue.c_str(), newValue.length(), validateOnly);
+  }
+  virtual bool update(const char* newValue, size_t length, bool validateOnly)
+  {
+    IPAddress ip;
+    if ((length >= IOTWEBCONF_NUMBER_TEXT_SIZE) || !parseIp(newValue, length, &ip))
+    {
+      return false;
+    }
+    if (!validateOnly && ((uint32_t)this->_value != (uint32_t)ip))
+    {
+      this->_value = ip;
+      this->markChanged();
+    }
+    return true;
   }
 
-  virtual String toString() override { return this->_value.toString(); }
+  virtual void renderJsonValue(JsonWriter* jsonWriter, const char* key) override
+  {
+    char text[IOTWEBCONF_NUMBER_TEXT_SIZE];
+    formatIp(this->_value, text, sizeof(text));
+    jsonWriter->writeString(key, text);
+  }
+  virtual String toString() override
+  {
+    char text[IOTWEBCONF_NUMBER_TEXT_SIZE];
+    formatIp(this->_value, text, sizeof(text));
+    return String(text);
+  }
 };
 
 ///////////////////////////////////////////////////////////////////////////
@@ -400,6 +691,62 @@ public:
 
   const char* errorMessage = NULL;
 
+  /**
+   * Rules for the value, rendered into the input field, and checked
+   *   when the form is posted.
+   */
+  InputConstraints constraints;
+
+  const char* checkConstraints(const char* value) override
+  {
+    return this->constraints.check(value);
+  }
+
+  /**
+   * Message of a custom form validator is not overwritten.
+   */
+  void validationFailed(const char* message) override
+  {
+    if (this->errorMessage == NULL)
+    {
+      this->errorMessage = message;
+    }
+  }
+
+  void renderJsonError(JsonWriter* jsonWriter) override
+  {
+    if (this->errorMessage != NULL)
+    {
+      jsonWriter->writeString(this->getId(), this->errorMessage);
+    }
+  }
+
+  void renderJsonSchema(JsonWriter* jsonWriter) override
+  {
+    jsonWriter->beginObject();
+    jsonWriter->writeString("i", this->getId());
+    jsonWriter->writeString("l", this->label);
+    jsonWriter->writeString("t", this->getInputType());
+    int length = this->getInputLength();
+    if (length > 0)
+    {
+      jsonWriter->writeNumber("m", String(length).c_str());
+    }
+    if (this->placeholder != NULL)
+    {
+      jsonWriter->writeString("p", this->placeholder);
+    }
+    const char* customHtml = this->getJsonSchemaCustomHtml();
+    if (customHtml != NULL)
+    {
+      jsonWriter->writeString("c", customHtml);
+    }
+    this->constraints.renderJsonSchema(jsonWriter);
+    this->renderJsonSchemaAttributes(jsonWriter);
+    this->renderJsonValue(jsonWriter, "v");
+    jsonWriter->endObject();
+  }
+
 protected:
   void clearErrorMessage() override
   {
@@ -419,14 +766,14 @@ protected:
     int length = this->getInputLength();
     if (length > 0)
     {
-      char parLength[5];
-      snprintf(parLength, 5, "%d", length);
-      String maxLength = String("maxlength=") + parLength;
-      pitem.replace("{l}", maxLength);
+      char parLength[IOTWEBCONF_NUMBER_TEXT_SIZE];
+      formatUnsigned(length, parLength, sizeof(parLength));
+      String maxLength = String("maxlength='") + parLength + "'";
+      pitem.replace("{l}", maxLength + this->constraints.renderHtml());
     }
     else
     {
-      pitem.replace("{l}", "");
+      pitem.replace("{l}", this->constraints.renderHtml());
     }
     if (hasValueFromPost)
     {
@@ -455,6 +802,16 @@ protected:
    */
   virtual String getHtmlTemplate() { return FPSTR(IOTWEBCONF_HTML_FORM_PARAM); };
   virtual const char* getInputType() = 0;
+
+  /**
+   * Custom HTML of the input field in the JSON schema.
+   */
+  virtual const char* getJsonSchemaCustomHtml() { return this->customHtml; }
+  /**
+   * One can override this method to add type specific members to the
+   * JSON schema of the parameter.
+   */
+  virtual void renderJsonSchemaAttributes(JsonWriter* jsonWriter) { }
 };
 
 template <size_t len>
@@ -482,6 +839,10 @@ public:
 
 protected:
   virtual const char* getInputType() override { return "checkbox"; }
+  /**
+   * Custom HTML is only used for rendering the checked state.
+   */
+  virtual const char* getJsonSchemaCustomHtml() override { return NULL; }
 
   virtual void update(WebRequestWrapper* webRequestWrapper) override
   {
@@ -491,13 +852,38 @@ protected:
         String valueFromPost = webRequestWrapper->arg(this->getId());
         selected = valueFromPost.equals("selected");
       }
+      else if (webRequestWrapper->isPartial())
+      {
+        return;
+      }
 //      this->update(String(selected ? "1" : "0"));
 #ifdef IOTWEBCONF_DEBUG_TO_SERIAL
       Serial.print(this->getId());
       Serial.print(": ");
       Serial.println(selected ? "selected" : "not selected");
 #endif
-      this->_value = selected;
+      if (this->_value != selected)
+      {
+        this->_value = selected;
+        this->markChanged();
+      }
+  }
+  /**
+   * Same values are accepted as by update(): "selected" for checked, and
+   *   empty (an unchecked checkbox of a JSON patch) or missing for unchecked.
+   */
+  virtual bool validate(WebRequestWrapper* webRequestWrapper) override
+  {
+    if (webRequestWrapper->hasArg(this->getId()))
+    {
+      String valueFromPost = webRequestWrapper->arg(this->getId());
+      if ((valueFromPost.length() > 0) && !valueFromPost.equals("selected"))
+      {
+        this->validationFailed("Invalid value.");
+        return false;
+      }
+    }
+    return true;
   }
 
   virtual String renderHtml(
@@ -561,9 +947,14 @@ using CharArrayDataType<len>::CharArrayDataType;
 #endif
   }
 
-  virtual bool update(String newValue, bool validateOnly) override
+  /**
+   * Password is never sent out.
+   */
+  void renderJsonValue(JsonWriter* jsonWriter, const char* key) override { }
+
+  virtual bool update(const char* newValue, size_t length, bool validateOnly) override
   {
-    if (newValue.length() + 1 > len)
+    if (length + 1 > len)
     {
       return false;
     }
@@ -576,10 +967,14 @@ using CharArrayDataType<len>::CharArrayDataType;
     Serial.print(this->getId());
     Serial.print(": ");
 #endif
-    if (newValue.length() > 0)
+    if (length > 0)
     {
       // -- Value was set.
-      strncpy(this->_value, newValue.c_str(), len);
+      if (strncmp(this->_value, newValue, len) != 0)
+      {
+        strncpy(this->_value, newValue, len);
+        this->markChanged();
+      }
 #ifdef IOTWEBCONF_DEBUG_TO_SERIAL
 # ifdef IOTWEBCONF_DEBUG_PWD_TO_SERIAL
       Serial.println(this->_value);
@@ -621,32 +1016,60 @@ public:
     ConfigItemBridge::ConfigItemBridge(id),
     InputParameter::InputParameter(id, label) { }
 
+  /**
+   * Limits are written in full precision (String(float) would cut them to
+   *   two decimals).
+   */
   virtual String getCustomHtml() override
   {
     String modifiers = String(this->customHtml);
+    char text[IOTWEBCONF_NUMBER_TEXT_SIZE];
 
     if (this->isMinDefined())
     {
+      formatNumber(this->getMin(), text, sizeof(text));
       modifiers += " min='" ;
-      modifiers += this->getMin();
+      modifiers += text;
       modifiers += "'";
     }
     if (this->isMaxDefined())
     {
+      formatNumber(this->getMax(), text, sizeof(text));
       modifiers += " max='";
-      modifiers += this->getMax();
+      modifiers += text;
       modifiers += "'";
     }
     if (this->step != 0)
     {
+      formatNumber(this->step, text, sizeof(text));
       modifiers += " step='";
-      modifiers += this->step;
+      modifiers += text;
       modifiers += "'";
     }
 
     return modifiers;
   }
 
+  virtual void renderJsonSchemaAttributes(JsonWriter* jsonWriter) override
+  {
+    char text[IOTWEBCONF_NUMBER_TEXT_SIZE];
+    if (this->isMinDefined())
+    {
+      formatNumber(this->getMin(), text, sizeof(text));
+      jsonWriter->writeNumber("min", text);
+    }
+    if (this->isMaxDefined())
+    {
+      formatNumber(this->getMax(), text, sizeof(text));
+      jsonWriter->writeNumber("max", text);
+    }
+    if (this->step != 0)
+    {
+      formatNumber(this->step, text, sizeof(text));
+      jsonWriter->writeNumber("step", text);
+    }
+  }
+
   ValueType step = 0;
   void setStep(ValueType step) { this->step = step; }
   virtual ValueType getMin() = 0;
@@ -801,6 +1224,20 @@ public:
     OptionsTParameter<len>(id, label, defaultValue) { }
 
 protected:
+  virtual const char* getInputType() override { return "select"; }
+  virtual void renderJsonSchemaAttributes(JsonWriter* jsonWriter) override
+  {
+    jsonWriter->beginArray("o");
+    for (size_t i=0; i<this->_optionCount; i++)
+    {
+      jsonWriter->beginArray();
+      jsonWriter->writeString(NULL, this->_optionValues + (i*len));
+      jsonWriter->writeString(NULL, this->_optionNames + (i*this->_nameLength));
+      jsonWriter->endArray();
+    }
+    jsonWriter->endArray();
+  }
+
   // Overrides
   virtual String renderHtml(
     bool dataArrived, bool hasValueFromPost, String valueFromPost) override
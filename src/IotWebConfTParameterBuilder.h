@@ -29,6 +29,7 @@ public:
   {
     ParamType instance = std::move(
       ParamType(this->_id, this->_label, this->_defaultValue));
+    instance.constraints = this->_constraints;
     this->apply(&instance);
     return instance;
   }
@@ -37,6 +38,12 @@ public:
     { this->_label = label; return static_cast<Builder<ParamType>&>(*this); }
   Builder<ParamType>& defaultValue(typename ParamType::DefaultValueType defaultValue)
     { this->_defaultValue = defaultValue; return static_cast<Builder<ParamType>&>(*this); }
+  Builder<ParamType>& required()
+    { this->_constraints.required = true; return static_cast<Builder<ParamType>&>(*this); }
+  Builder<ParamType>& minLength(int minLength)
+    { this->_constraints.minLength = minLength; return static_cast<Builder<ParamType>&>(*this); }
+  Builder<ParamType>& pattern(const InputPattern* pattern)
+    { this->_constraints.pattern = pattern; return static_cast<Builder<ParamType>&>(*this); }
 
 protected:
   virtual ParamType* apply(ParamType* instance) const
@@ -46,6 +53,7 @@ protected:
   const char* _label;
   const char* _id;
   typename ParamType::DefaultValueType _defaultValue;
+  InputConstraints _constraints;
 };
 
 template <typename ParamType>
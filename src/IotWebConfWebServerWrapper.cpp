@@ -0,0 +1,366 @@
+/**
+ * IotWebConfWebServerWrapper.cpp -- IotWebConf is an ESP8266/ESP32
+ *   non blocking WiFi/AP web configuration library for Arduino.
+ *   https://github.com/prampec/IotWebConf
+ *
+ * Copyright (C) 2020 Balazs Kelemen <prampec+arduino@gmail.com>
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <algorithm>
+#include <IotWebConfWebServerWrapper.h>
+
+namespace iotwebconf
+{
+
+IndexedWebRequestWrapper::IndexedWebRequestWrapper(
+  WebRequestWrapper* original) :
+  IndexedWebRequestWrapper(original, true)
+{
+}
+
+IndexedWebRequestWrapper::IndexedWebRequestWrapper(
+  WebRequestWrapper* original, bool collectArgs) :
+  DelegatingWebRequestWrapper(original)
+{
+  if (!collectArgs)
+  {
+    return;
+  }
+  int count = original->args();
+  if (count < 0)
+  {
+    // -- Original can not list its arguments, lookups are forwarded.
+    return;
+  }
+  this->_capacity = count;
+  this->_entries = new ArgEntry[count];
+  for (int i = 0; i < count; i++)
+  {
+    String name = original->argName(i);
+    String value = original->argValue(i);
+    this->addArg(name.c_str(), name.length(), value.c_str(), value.length());
+  }
+  this->buildIndex();
+}
+
+IndexedWebRequestWrapper::~IndexedWebRequestWrapper()
+{
+  delete[] this->_entries;
+}
+
+IndexedWebRequestWrapper::ArgEntry* IndexedWebRequestWrapper::newEntry()
+{
+  if (this->_count == this->_capacity)
+  {
+    int capacity = this->_capacity < 8 ? 8 : this->_capacity * 2;
+    ArgEntry* entries = new ArgEntry[capacity];
+    for (int i = 0; i < this->_count; i++)
+    {
+      entries[i] = this->_entries[i];
+    }
+    delete[] this->_entries;
+    this->_entries = entries;
+    this->_capacity = capacity;
+  }
+  return &this->_entries[this->_count++];
+}
+
+void IndexedWebRequestWrapper::addArg(
+  const char* name, size_t nameLength, const char* value, size_t valueLength)
+{
+  ArgEntry* entry = this->newEntry();
+  entry->nameStart = this->_buffer.length();
+  entry->nameLength = nameLength;
+  this->_buffer.concat(name, nameLength);
+  entry->valueStart = this->_buffer.length();
+  entry->valueLength = valueLength;
+  this->_buffer.concat(value, valueLength);
+}
+
+void IndexedWebRequestWrapper::decodeForm(const char* data, size_t length)
+{
+  // -- Decoded content is never longer than the encoded one.
+  this->_buffer.reserve(
+    std::min(this->_buffer.length() + length, this->_maxFormLength));
+  for (size_t i = 0; (i < length) && !this->_formTooLarge; i++)
+  {
+    char c = data[i];
+    if (this->_hexDigits > 0)
+    {
+      int digit = -1;
+      if ((c >= '0') && (c <= '9')) { digit = c - '0'; }
+      else if ((c >= 'a') && (c <= 'f')) { digit = c - 'a' + 10; }
+      else if ((c >= 'A') && (c <= 'F')) { digit = c - 'A' + 10; }
+      if (digit >= 0)
+      {
+        this->_hexValue = (this->_hexValue << 4) | digit;
+        if (this->_hexDigits == 2)
+        {
+          this->_hexFirst = c;
+        }
+        if (--this->_hexDigits == 0)
+        {
+          this->appendDecoded((char)this->_hexValue);
+        }
+        continue;
+      }
+      // -- Not an escape: kept literally, and the character is processed
+      //    as usual (like urlDecode() of the WebServer does).
+      this->flushEscape();
+    }
+
+    if (c == '&')
+    {
+      this->finishField();
+    }
+    else if ((c == '=') && (this->_decodeState != DecodeValue))
+    {
+      this->appendDecoded('\0'); // -- Opens the field, if it was empty.
+      if (this->_formTooLarge)
+      {
+        return;
+      }
+      this->_decodeState = DecodeValue;
+      ArgEntry* entry = &this->_entries[this->_count - 1];
+      entry->valueStart = this->_buffer.length();
+    }
+    else if (c == '%')
+    {
+      this->_hexDigits = 2;
+      this->_hexValue = 0;
+    }
+    else
+    {
+      this->appendDecoded(c == '+' ? ' ' : c);
+    }
+  }
+}
+
+void IndexedWebRequestWrapper::finishForm()
+{
+  this->finishField();
+  this->buildIndex();
+}
+
+void IndexedWebRequestWrapper::appendDecoded(char c)
+{
+  if (this->_decodeState == DecodeNone)
+  {
+    if (this->_count >= this->_maxArgs)
+    {
+      this->_formTooLarge = true;
+      return;
+    }
+    ArgEntry* entry = this->newEntry();
+    entry->nameStart = this->_buffer.length();
+    entry->nameLength = 0;
+    entry->valueStart = this->_buffer.length();
+    entry->valueLength = 0;
+    this->_decodeState = DecodeName;
+  }
+  if (c == '\0')
+  {
+    return;
+  }
+  if (this->_buffer.length() >= this->_maxFormLength)
+  {
+    this->_formTooLarge = true;
+    return;
+  }
+  ArgEntry* entry = &this->_entries[this->_count - 1];
+  this->_buffer += c;
+  if (this->_decodeState == DecodeName)
+  {
+    entry->nameLength += 1;
+  }
+  else
+  {
+    entry->valueLength += 1;
+  }
+}
+
+void IndexedWebRequestWrapper::flushEscape()
+{
+  byte consumed = 2 - this->_hexDigits;
+  this->_hexDigits = 0;
+  this->appendDecoded('%');
+  if (consumed > 0)
+  {
+    this->appendDecoded(this->_hexFirst);
+  }
+}
+
+void IndexedWebRequestWrapper::finishField()
+{
+  if (this->_hexDigits > 0)
+  {
+    // -- A '%' at the end of the field.
+    this->flushEscape();
+  }
+  if (this->_decodeState == DecodeName)
+  {
+    // -- Field without '=', value is empty.
+    ArgEntry* entry = &this->_entries[this->_count - 1];
+    entry->valueStart = this->_buffer.length();
+  }
+  this->_decodeState = DecodeNone;
+  this->_hexDigits = 0;
+}
+
+void IndexedWebRequestWrapper::buildIndex()
+{
+  const char* buffer = this->_buffer.c_str();
+  // -- Stable sort keeps the first occurrence of a name first, so that
+  //    duplicates are resolved the same way as by the WebServer.
+  std::stable_sort(this->_entries, this->_entries + this->_count,
+    [&](const ArgEntry& a, const ArgEntry& b)
+    {
+      int result = memcmp(buffer + a.nameStart, buffer + b.nameStart,
+        std::min(a.nameLength, b.nameLength));
+      return (result < 0) || ((result == 0) && (a.nameLength < b.nameLength));
+    });
+  this->_indexed = true;
+}
+
+int IndexedWebRequestWrapper::compare(
+  const ArgEntry* entry, const char* name, size_t nameLength)
+{
+  int result = memcmp(this->_buffer.c_str() + entry->nameStart, name,
+    std::min(entry->nameLength, nameLength));
+  if (result != 0)
+  {
+    return result;
+  }
+  return (entry->nameLength < nameLength) ? -1 :
+    ((entry->nameLength > nameLength) ? 1 : 0);
+}
+
+int IndexedWebRequestWrapper::find(const char* name, size_t nameLength)
+{
+  // -- Binary search for the first entry not less than name.
+  int low = 0;
+  int high = this->_count;
+  while (low < high)
+  {
+    int middle = (low + high) / 2;
+    if (this->compare(&this->_entries[middle], name, nameLength) < 0)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+  if ((low < this->_count)
+    && (this->compare(&this->_entries[low], name, nameLength) == 0))
+  {
+    return low;
+  }
+  return -1;
+}
+
+bool IndexedWebRequestWrapper::hasArg(const String& name)
+{
+  return this->hasArg(name.c_str(), name.length());
+}
+
+bool IndexedWebRequestWrapper::hasArg(const char* name, size_t nameLength)
+{
+  if (!this->_indexed)
+  {
+    return this->_original->hasArg(name, nameLength);
+  }
+  return this->find(name, nameLength) >= 0;
+}
+
+String IndexedWebRequestWrapper::arg(const String name)
+{
+  return this->arg(name.c_str(), name.length());
+}
+
+String IndexedWebRequestWrapper::arg(const char* name, size_t nameLength)
+{
+  if (!this->_indexed)
+  {
+    return this->_original->arg(name, nameLength);
+  }
+  int i = this->find(name, nameLength);
+  return this->argValue(i);
+}
+
+int IndexedWebRequestWrapper::args()
+{
+  if (!this->_indexed)
+  {
+    return this->_original->args();
+  }
+  return this->_count;
+}
+
+size_t IndexedWebRequestWrapper::readArg(
+  const String& name, char* buffer, size_t size)
+{
+  return this->readArg(name.c_str(), name.length(), buffer, size);
+}
+
+size_t IndexedWebRequestWrapper::readArg(
+  const char* name, size_t nameLength, char* buffer, size_t size)
+{
+  if (!this->_indexed)
+  {
+    return this->_original->readArg(name, nameLength, buffer, size);
+  }
+  int i = this->find(name, nameLength);
+  if (size == 0)
+  {
+    return i < 0 ? 0 : this->_entries[i].valueLength;
+  }
+  if (i < 0)
+  {
+    buffer[0] = '\0';
+    return 0;
+  }
+  ArgEntry* entry = &this->_entries[i];
+  size_t length = std::min(entry->valueLength, size - 1);
+  memcpy(buffer, this->_buffer.c_str() + entry->valueStart, length);
+  buffer[length] = '\0';
+  return entry->valueLength;
+}
+
+String IndexedWebRequestWrapper::argName(int i)
+{
+  if (!this->_indexed)
+  {
+    return this->_original->argName(i);
+  }
+  String result;
+  if ((0 <= i) && (i < this->_count))
+  {
+    result.concat(
+      this->_buffer.c_str() + this->_entries[i].nameStart,
+      this->_entries[i].nameLength);
+  }
+  return result;
+}
+
+String IndexedWebRequestWrapper::argValue(int i)
+{
+  if (!this->_indexed)
+  {
+    return this->_original->argValue(i);
+  }
+  String result;
+  if ((0 <= i) && (i < this->_count))
+  {
+    result.concat(
+      this->_buffer.c_str() + this->_entries[i].valueStart,
+      this->_entries[i].valueLength);
+  }
+  return result;
+}
+
+} // end namespace
@@ -14,32 +14,441 @@
 
 #include <Arduino.h>
 #include <IPAddress.h>
+#include <limits.h>
+#include <stdint.h>
+#include <IotWebConfSettings.h>
 
 namespace iotwebconf
 {
 
+/**
+ * Connection of a request kept open after the handler returned, for sending
+ * content to the client later on (see WebRequestWrapper::openStream()).
+ */
+class WebStream
+{
+public:
+  virtual ~WebStream() { };
+  /**
+   * Returns false, when the client is gone. Nothing is sent anymore then,
+   *   the stream should be deleted.
+   */
+  virtual bool connected() = 0;
+  /**
+   * Send data to the client without waiting for it. The data is either
+   *   taken as a whole, or false is returned (the client is gone, or not
+   *   reading fast enough).
+   */
+  virtual bool write(const char* data, size_t length) = 0;
+  /**
+   * End the response, and give the connection back to the web server.
+   */
+  virtual void close() = 0;
+};
+
 class WebRequestWrapper
 {
 public:
-  virtual const String hostHeader() const;
-  virtual IPAddress localIP();
-  virtual const String uri() const;
-  virtual bool authenticate(const char * username, const char * password);
-  virtual void requestAuthentication();
-  virtual bool hasArg(const String& name);
-  virtual String arg(const String name);
-  virtual void sendHeader(const String& name, const String& value, bool first = false);
-  virtual void setContentLength(const size_t contentLength);
-  virtual void send(int code, const char* content_type = NULL, const String& content = String(""));
-  virtual void sendContent(const String& content);
-  virtual void stop();
+  virtual const String hostHeader() const = 0;
+  virtual IPAddress localIP() = 0;
+  virtual const String uri() const = 0;
+  virtual bool authenticate(const char * username, const char * password) = 0;
+  virtual void requestAuthentication() = 0;
+  virtual bool hasArg(const String& name) = 0;
+  virtual String arg(const String name) = 0;
+  virtual void sendHeader(const String& name, const String& value, bool first = false) = 0;
+  virtual void setContentLength(const size_t contentLength) = 0;
+  virtual void send(int code, const char* content_type = NULL, const String& content = String("")) = 0;
+  virtual void sendContent(const String& content) = 0;
+  virtual void sendContent_P(PGM_P content, size_t size) = 0;
+  virtual void stop() = 0;
+
+  /**
+   * Optional methods for walking through all arguments of the request.
+   *   Wrappers not able to do so return -1 for args().
+   */
+  virtual int args() { return -1; };
+  virtual String argName(int i) { return String(""); };
+  virtual String argValue(int i) { return String(""); };
+
+  /**
+   * Copy the value of an argument into a buffer of 'size' bytes, without
+   *   creating a String (if the wrapper supports it). The result is always
+   *   zero terminated. Returns the length of the whole value, that is
+   *   size or more, when the value did not fit into the buffer.
+   */
+  virtual size_t readArg(const String& name, char* buffer, size_t size)
+  {
+    String value = this->arg(name);
+    if (size == 0)
+    {
+      return value.length();
+    }
+    strncpy(buffer, value.c_str(), size);
+    buffer[size - 1] = '\0';
+    return value.length();
+  };
+
+  /**
+   * Argument lookups with the name given as a pointer and a length (not
+   *   necessarily zero terminated), so that no String is created for the
+   *   name. The defaults still create one, wrappers able to look up a name
+   *   without it override these.
+   */
+  virtual bool hasArg(const char* name, size_t nameLength)
+  {
+    String nameString;
+    nameString.concat(name, nameLength);
+    return this->hasArg(nameString);
+  };
+  virtual String arg(const char* name, size_t nameLength)
+  {
+    String nameString;
+    nameString.concat(name, nameLength);
+    return this->arg(nameString);
+  };
+  virtual size_t readArg(
+    const char* name, size_t nameLength, char* buffer, size_t size)
+  {
+    String nameString;
+    nameString.concat(name, nameLength);
+    return this->readArg(nameString, buffer, size);
+  };
+  bool hasArg(const char* name) { return this->hasArg(name, strlen(name)); };
+  String arg(const char* name) { return this->arg(name, strlen(name)); };
+  size_t readArg(const char* name, char* buffer, size_t size)
+  {
+    return this->readArg(name, strlen(name), buffer, size);
+  };
+
+  /**
+   * Copy the Host header or the URI of the request into a buffer of 'size'
+   *   bytes, like readArg() does. Used for the checks done on every request
+   *   (see IotWebConf::handleCaptivePortal()). The defaults create a String,
+   *   wrappers holding these as a whole override them.
+   */
+  virtual size_t readHostHeader(char* buffer, size_t size)
+  {
+    return copyValue(this->hostHeader(), buffer, size);
+  };
+  virtual size_t readUri(char* buffer, size_t size)
+  {
+    return copyValue(this->uri(), buffer, size);
+  };
+
+  /**
+   * Sending without creating Strings: header given as zero terminated
+   *   strings, content as a pointer and a length. The defaults create the
+   *   Strings (or read the content with sendContent_P(), that works on
+   *   RAM as well), wrappers able to do better override these.
+   */
+  virtual void sendHeader(const char* name, const char* value, bool first = false)
+  {
+    this->sendHeader(String(name), String(value), first);
+  };
+  virtual void send(
+    int code, const char* content_type, const char* content, size_t length)
+  {
+    String contentString;
+    contentString.concat(content, length);
+    this->send(code, content_type, contentString);
+  };
+  virtual void sendContent(const char* content, size_t length)
+  {
+    this->sendContent_P(content, length);
+  };
+  /**
+   * Send a whole response, with both the content type and the content in
+   *   program memory (PROGMEM).
+   */
+  virtual void send_P(int code, PGM_P content_type, PGM_P content, size_t length)
+  {
+    char contentType[64];
+    strncpy_P(contentType, content_type, sizeof(contentType) - 1);
+    contentType[sizeof(contentType) - 1] = '\0';
+    this->setContentLength(length);
+    this->send(code, contentType, "", 0);
+    this->sendContent_P(content, length);
+  };
+
+  /**
+   * A partial request carries only the values to be changed, items not
+   *   present in the request are left untouched. (E.g. a missing checkbox
+   *   does not mean it was unchecked.)
+   */
+  virtual bool isPartial() { return false; };
+
+  /**
+   * Value of a header of the request, or an empty String if not present.
+   *   Wrappers not able to read headers always return an empty String.
+   */
+  virtual String header(const String& name) { return String(""); };
+
+  /**
+   * Start a response with unknown length (status 200 with the content type
+   *   given), that is continued after the handler returned. Content is then
+   *   sent through the stream returned, the caller should delete it when
+   *   done (that also closes it). Returns NULL (and nothing is sent), if
+   *   the wrapper is not able to keep the connection.
+   */
+  virtual WebStream* openStream(const char* content_type) { return NULL; };
+
+protected:
+  static size_t copyValue(const String& value, char* buffer, size_t size)
+  {
+    if (size > 0)
+    {
+      strncpy(buffer, value.c_str(), size);
+      buffer[size - 1] = '\0';
+    }
+    return value.length();
+  };
+};
+
+/**
+ * Forwards every call to an other WebRequestWrapper. Inherit this class
+ * when only some aspects of a request should be altered (e.g. arguments
+ * are provided from a different source).
+ */
+class DelegatingWebRequestWrapper : public WebRequestWrapper
+{
+public:
+  DelegatingWebRequestWrapper(WebRequestWrapper* original) { this->_original = original; };
+
+  const String hostHeader() const override { return this->_original->hostHeader(); };
+  IPAddress localIP() override { return this->_original->localIP(); };
+  const String uri() const override { return this->_original->uri(); };
+  bool authenticate(const char * username, const char * password) override
+  {
+    return this->_original->authenticate(username, password);
+  };
+  void requestAuthentication() override { this->_original->requestAuthentication(); };
+  bool hasArg(const String& name) override { return this->_original->hasArg(name); };
+  String arg(const String name) override { return this->_original->arg(name); };
+  int args() override { return this->_original->args(); };
+  String argName(int i) override { return this->_original->argName(i); };
+  String argValue(int i) override { return this->_original->argValue(i); };
+  size_t readArg(const String& name, char* buffer, size_t size) override
+  {
+    return this->_original->readArg(name, buffer, size);
+  };
+  bool hasArg(const char* name, size_t nameLength) override
+  {
+    return this->_original->hasArg(name, nameLength);
+  };
+  String arg(const char* name, size_t nameLength) override
+  {
+    return this->_original->arg(name, nameLength);
+  };
+  size_t readArg(
+    const char* name, size_t nameLength, char* buffer, size_t size) override
+  {
+    return this->_original->readArg(name, nameLength, buffer, size);
+  };
+  using WebRequestWrapper::hasArg;
+  using WebRequestWrapper::arg;
+  using WebRequestWrapper::readArg;
+  size_t readHostHeader(char* buffer, size_t size) override
+  {
+    return this->_original->readHostHeader(buffer, size);
+  };
+  size_t readUri(char* buffer, size_t size) override
+  {
+    return this->_original->readUri(buffer, size);
+  };
+  bool isPartial() override { return this->_original->isPartial(); };
+  String header(const String& name) override { return this->_original->header(name); };
+  WebStream* openStream(const char* content_type) override
+  {
+    return this->_original->openStream(content_type);
+  };
+  void sendHeader(const String& name, const String& value, bool first = false) override
+  {
+    this->_original->sendHeader(name, value, first);
+  };
+  void setContentLength(const size_t contentLength) override
+  {
+    this->_original->setContentLength(contentLength);
+  };
+  void send(int code, const char* content_type = NULL, const String& content = String("")) override
+  {
+    this->_original->send(code, content_type, content);
+  };
+  void sendHeader(const char* name, const char* value, bool first = false) override
+  {
+    this->_original->sendHeader(name, value, first);
+  };
+  void send(
+    int code, const char* content_type, const char* content, size_t length) override
+  {
+    this->_original->send(code, content_type, content, length);
+  };
+  void send_P(int code, PGM_P content_type, PGM_P content, size_t length) override
+  {
+    this->_original->send_P(code, content_type, content, length);
+  };
+  void sendContent(const String& content) override { this->_original->sendContent(content); };
+  void sendContent(const char* content, size_t length) override
+  {
+    this->_original->sendContent(content, length);
+  };
+  void sendContent_P(PGM_P content, size_t size) override
+  {
+    this->_original->sendContent_P(content, size);
+  };
+  void stop() override { this->_original->stop(); };
+
+protected:
+  WebRequestWrapper* _original;
+};
+
+/**
+ * Collects all arguments of the request once, and keeps them sorted by name,
+ * so that looking up an argument is a binary search instead of a linear scan
+ * (and a String copy) of the whole argument list for every config item.
+ * If the original wrapper can not walk through its arguments, all lookups
+ * are forwarded to it.
+ * Arguments can also be provided by decoding a raw form post body
+ * (application/x-www-form-urlencoded) arriving in parts, e.g. from a
+ * server streaming the request body. Values are percent-decoded straight
+ * into the argument buffer, thus the raw body never needs to be in memory
+ * as a whole.
+ */
+class IndexedWebRequestWrapper : public DelegatingWebRequestWrapper
+{
+public:
+  IndexedWebRequestWrapper(WebRequestWrapper* original);
+  /**
+   * With collectArgs false, the arguments of the original wrapper are not
+   *   used. Arguments should be provided by decodeForm(), and finishForm()
+   *   must be called after the last part.
+   */
+  IndexedWebRequestWrapper(WebRequestWrapper* original, bool collectArgs);
+  ~IndexedWebRequestWrapper();
+
+  void decodeForm(const char* data, size_t length);
+  void finishForm();
+  /**
+   * Limits of the arguments decoded by decodeForm(): at most 'maxLength'
+   *   bytes of names and values, and at most 'maxArgs' arguments. The rest
+   *   of the form is dropped, and isFormTooLarge() returns true. There are
+   *   no limits by default. (Single values are never cut, so a value is
+   *   either whole, or the form is rejected.)
+   */
+  void setFormLimits(size_t maxLength, int maxArgs)
+  {
+    this->_maxFormLength = maxLength;
+    this->_maxArgs = maxArgs;
+  };
+  bool isFormTooLarge() { return this->_formTooLarge; };
+
+  bool hasArg(const String& name) override;
+  bool hasArg(const char* name, size_t nameLength) override;
+  String arg(const String name) override;
+  String arg(const char* name, size_t nameLength) override;
+  int args() override;
+  String argName(int i) override;
+  String argValue(int i) override;
+  size_t readArg(const String& name, char* buffer, size_t size) override;
+  size_t readArg(
+    const char* name, size_t nameLength, char* buffer, size_t size) override;
+  using DelegatingWebRequestWrapper::hasArg;
+  using DelegatingWebRequestWrapper::arg;
+  using DelegatingWebRequestWrapper::readArg;
+  bool isPartial() override
+  {
+    return this->_partial || DelegatingWebRequestWrapper::isPartial();
+  };
+  void setPartial(bool partial) { this->_partial = partial; };
+
+protected:
+  /**
+   * For subclasses providing the arguments by themselves. buildIndex() must
+   *   be called after the last argument was added.
+   */
+  void addArg(const char* name, size_t nameLength, const char* value, size_t valueLength);
+  void buildIndex();
+
+private:
+  typedef struct ArgEntry
+  {
+    size_t nameStart;
+    size_t nameLength;
+    size_t valueStart;
+    size_t valueLength;
+  } ArgEntry;
+
+  // -- Names and values are stored one after the other in a single buffer.
+  String _buffer;
+  ArgEntry* _entries = NULL;
+  int _count = 0;
+  int _capacity = 0;
+  bool _indexed = false;
+  bool _partial = false;
+  size_t _maxFormLength = SIZE_MAX;
+  int _maxArgs = INT_MAX;
+  bool _formTooLarge = false;
+
+  // -- Form decoding state.
+  enum { DecodeNone, DecodeName, DecodeValue } _decodeState = DecodeNone;
+  byte _hexDigits = 0;
+  byte _hexValue = 0;
+  char _hexFirst = 0;
+
+  ArgEntry* newEntry();
+  void appendDecoded(char c);
+  void flushEscape();
+  void finishField();
+  int find(const char* name, size_t nameLength);
+  int compare(const ArgEntry* entry, const char* name, size_t nameLength);
+};
+
+/**
+ * Sends nothing, but counts the bytes of the content that would be sent. Used
+ * for a dry-run rendering to calculate the exact Content-Length.
+ */
+class CountingWebRequestWrapper : public DelegatingWebRequestWrapper
+{
+public:
+  CountingWebRequestWrapper(WebRequestWrapper* original) :
+    DelegatingWebRequestWrapper(original) { };
+
+  void sendHeader(const String& name, const String& value, bool first = false) override { };
+  void sendHeader(const char* name, const char* value, bool first = false) override { };
+  void setContentLength(const size_t contentLength) override { };
+  void send(int code, const char* content_type = NULL, const String& content = String("")) override
+  {
+    this->_contentLength += content.length();
+  };
+  void send(
+    int code, const char* content_type, const char* content, size_t length) override
+  {
+    this->_contentLength += length;
+  };
+  void send_P(int code, PGM_P content_type, PGM_P content, size_t length) override
+  {
+    this->_contentLength += length;
+  };
+  void sendContent(const String& content) override { this->_contentLength += content.length(); };
+  void sendContent(const char* content, size_t length) override { this->_contentLength += length; };
+  void sendContent_P(PGM_P content, size_t size) override { this->_contentLength += size; };
+  void stop() override { };
+  WebStream* openStream(const char* content_type) override { return NULL; };
+
+  size_t getContentLength() { return this->_contentLength; };
+
+private:
+  size_t _contentLength = 0;
 };
 
 class WebServerWrapper
 {
 public:
-  virtual void handleClient();
-  virtual void begin();
+  /**
+   * Serve the clients. Returns true, if a request was served.
+   */
+  virtual bool handleClient() = 0;
+  virtual void begin() = 0;
 };
 
 } // end namespace